@@ -0,0 +1,15 @@
+#!/bin/sh
+# make file for GNU C++ compiler (Linux)
+rm -rf ./bin
+mkdir bin
+cd ./bin
+if [ "$1" = "DEBUG" ]; then
+  CXXFLAGS="-g -O0"
+else
+  CXXFLAGS="-O2"
+fi
+g++ $CXXFLAGS -Wall -I../ -o osfio_tb ../osfio_tb.cpp ../osfio.cpp
+if [ -f osfio_tb ]; then ./osfio_tb; fi
+g++ $CXXFLAGS -Wall -I../ -o osndxfio_tb ../osndxfio_tb.cpp ../osfio.cpp ../osndxfio.cpp -pthread
+if [ -f osndxfio_tb ]; then ./osndxfio_tb; fi
+cd ..
@@ -23,7 +23,11 @@
  */
 
 // ---- system include files ----
+#if defined( __linux__ )
+#include <stdio.h>
+#else
 #include <conio.h>
+#endif
 
 #ifdef __CPPBUILDERIDE__
 #ifdef __cplusplus
@@ -43,10 +47,23 @@ typedef unsigned char         bool;
 typedef unsigned char         BYTE;
 typedef short                 S16;
 typedef unsigned short        U16;
+#if defined( __LP64__ ) || defined( _LP64 )
+typedef int                   S32; // long is 64 bits on LP64 targets.
+typedef unsigned int          U32;
+#else
 typedef long                  S32;
 typedef unsigned long         U32;
+#endif
+#if defined( __LP64__ ) || defined( _LP64 )
 typedef long int              S64;
 typedef unsigned long int     U64;
+#elif defined( _MSC_VER ) || defined( __BORLANDC__ )
+typedef __int64               S64;
+typedef unsigned __int64      U64;
+#else
+typedef long long             S64;
+typedef unsigned long long    U64;
+#endif
 typedef float                 R32;
 typedef double                R64;
 typedef long double           R80;
@@ -100,6 +117,10 @@ typedef long double           R80;
 #define UNSUCCESSFUL_RETURN   return FALSE
 #endif
 
+#if defined( __linux__ )
+#define WAIT_FOR_KEYPRESSED   getchar()
+#else
 #define WAIT_FOR_KEYPRESSED   getch()
+#endif
 
 #endif /* OSDEF_H */
@@ -17,26 +17,316 @@
  *  License: LGPL, v3, as defined and found on www.gnu.org,
  *           https://www.gnu.org/licenses/lgpl-3.0.html
  *
- *  Description: File I/O (POSIX)
+ *  Description: File I/O (POSIX). On Linux positional I/O is done by
+ *               pread()/pwrite(), the file pointer is kept by OSFIO.
+ *               Mounted storages (OSSTORAGE) replace files by name.
  */
 
 // ---- include files ----
+#if defined( __linux__ )
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t on 32-bit Linux as well.
+#endif
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <fcntl.h>
-#include <sys\stat.h>
-#include <io.h>
+#include <sys/stat.h>
 
 // ---- application includes ----
 #include <osfio.hpp>
 
+#ifdef OSFIO_LINUX
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined( __has_include )
+#if __has_include( <linux/io_uring.h> )
+#define OSFIO_URING       // Asynchronous queue by io_uring system calls.
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+#else
+#include <io.h>
+#endif
+
 // ---- local symbol definitions ----
 #define SUCCESSFUL        0
 #define ERROR             (-1)
+#define STORAGE_HANDLE    (-2) // Handle of a mounted storage, no file.
+#define STORAGE_MINIMUM   65536 // Initial capacity of heap memory.
+
+#ifdef OSFIO_LINUX
+#define O_BINARY          0 // No text mode translation on Linux.
+#define IO_VECTOR_CHUNK   64 // Pieces per pwritev() call, less than IOV_MAX.
+#define DIRECT_BUFFER_SIZE ( 64 * DIRECT_ALIGNMENT ) // Direct I/O transfer size.
+#ifndef O_DIRECT
+#define O_DIRECT          0 // Direct I/O not supported.
+#endif
+#define S_IREAD           S_IRUSR
+#define S_IWRITE          S_IWUSR
+#elif defined( _MSC_VER )
+#define LSEEK             ::_lseeki64 // 64-bit file offsets.
+#define FILELENGTH        ::_filelengthi64
+#define CHSIZE( h, s )    (( ::_chsize_s( (h), (s) ) == 0 ) ? 0 : ERROR )
+#else
+#define LSEEK             ::lseek
+#define FILELENGTH        ::filelength
+#define CHSIZE( h, s )    ::chsize( (h), (s) )
+#endif
+
+#define QUEUE_CHUNK       64 // Initial number of queued requests.
+#define NO_BLOCK          U32( -1 )
+#define ALIGN_DOWN( v )   ( U64( v ) & ~U64( DIRECT_ALIGNMENT - 1 ))
+#define ALIGN_UP( v )     ALIGN_DOWN( U64( v ) + DIRECT_ALIGNMENT - 1 )
+
+// ---- local type definitions ----
+struct OSFIO::sIO_REQUEST {
+    U64   position;
+    BYTE* pData;
+    U32   dataSize;
+    bool  write;
+};
+
+/** Cache block descriptor, blocks are linked in hash chains and LRU order. */
+struct sCACHE_BLOCK {
+    U64 blockNr;   // File offset / CACHE_BLOCK_SIZE.
+    U32 hashNext;  // Next block in the hash chain.
+    U32 prev;      // More recently used block.
+    U32 next;      // Less recently used block.
+};
+
+struct OSFIO::sCACHE {
+    U32           nrOfBlocks;
+    U32           nrOfUsed;   // Blocks nrOfUsed.. were never used.
+    U32           freeHead;   // Invalidated blocks, linked by hashNext.
+    U32           hashMask;   // Hash table size - 1, power of 2.
+    U32           lruHead;    // Most recently used block.
+    U32           lruTail;    // Least recently used block.
+    BYTE*         pMemory;    // Allocation of the block data.
+    BYTE*         pData;      // Aligned block data.
+    sCACHE_BLOCK* pBlock;
+    U32*          pHash;      // First block of every hash chain.
+    sCACHE_STATS  stats;
+};
+
+/** Mounted storage, see OSFIO::mount(). */
+struct sMOUNT {
+    STRING     pName;
+    OSSTORAGE* pStorage;
+    bool       owned;   // Created by OSFIO::create(), released by erase().
+    sMOUNT*    pNext;
+};
+
+// ---- local functions ----
+static U64 clockTime();
+static bool isStorageName( const STRING name );
+static sMOUNT* findMount( const STRING name );
+static bool addMount( const STRING name, OSSTORAGE* pStorage, bool owned );
+static OSFIO::sCACHE* openCache( U32 in_cacheSize );
+static void closeCache( OSFIO::sCACHE* pCache );
+static U32 findBlock( OSFIO::sCACHE* pCache, U64 blockNr );
+static U32 allocateBlock( OSFIO::sCACHE* pCache );
+static void insertBlock( OSFIO::sCACHE* pCache, U32 block, U64 blockNr );
+static void releaseBlock( OSFIO::sCACHE* pCache, U32 block );
+static void invalidateBlocks( OSFIO::sCACHE* pCache, U64 position, U64 dataSize );
+
+#ifdef OSFIO_URING
+struct OSFIO::sRING {
+    int            fd;
+    U32            entries;
+    void*          pSq;       // Submission queue ring mapping.
+    size_t         sqSize;
+    void*          pCq;       // Completion queue ring mapping, may be pSq.
+    size_t         cqSize;
+    io_uring_sqe*  pSqes;     // Submission queue entries mapping.
+    size_t         sqesSize;
+    unsigned*      pSqTail;
+    unsigned*      pSqMask;
+    unsigned*      pSqArray;
+    unsigned*      pCqHead;
+    unsigned*      pCqTail;
+    unsigned*      pCqMask;
+    io_uring_cqe*  pCqes;
+};
+
+static OSFIO::sRING* openRing( U32 in_entries );
+static void closeRing( OSFIO::sRING* pRing );
+#else
+struct OSFIO::sRING {
+    int fd;
+};
+#endif
+
+// ---- local data ----
+static sMOUNT* pMountListEntry = NULL;
+
+// ---- constructor ----
+OSMEMORY::OSMEMORY()
+    :
+    m_pData( NULL ),
+    m_size( 0 ),
+    m_capacity( 0 ),
+    m_region( false ),
+    m_timestamp( (U32)::time( NULL )) {
+}
+
+OSMEMORY::OSMEMORY( BYTE* in_pRegion,
+                    U64   in_capacity,
+                    U64   in_size )
+    :
+    m_pData( in_pRegion ),
+    m_size( MIN( in_size, in_capacity )),
+    m_capacity( in_capacity ),
+    m_region( true ),
+    m_timestamp( (U32)::time( NULL )) {
+}
+
+// ---- destructor ----
+OSMEMORY::~OSMEMORY() {
+    if ( !m_region ) {
+        ::free( m_pData );
+    }
+}
+
+/*============================================================================*/
+S64 OSMEMORY::read( U64     in_position,
+                    POINTER out_dataPtr,
+                    U32     in_dataSize )
+/*============================================================================*/
+{
+    if ( in_position >= m_size ) {
+        return 0; // End of storage.
+    }
+
+    U64 dataSize = MIN( U64( in_dataSize ), ( m_size - in_position ));
+
+    ::memcpy( out_dataPtr, ( m_pData + in_position ), (size_t)dataSize );
+
+    return (S64)dataSize;
+}
+
+/*============================================================================*/
+bool OSMEMORY::write( U64           in_position,
+                      const POINTER in_dataPtr,
+                      U32           in_dataSize )
+/*============================================================================*/
+{
+    U64 end = in_position + in_dataSize;
+
+    if (( end < in_position ) || !reserve( end )) {
+        return false;
+    }
+
+    if ( in_position > m_size ) {
+        ::memset(( m_pData + m_size ), 0, (size_t)( in_position - m_size ));
+    }
+
+    ::memcpy(( m_pData + in_position ), in_dataPtr, in_dataSize );
+
+    m_size      = MAX( m_size, end );
+    m_timestamp = (U32)::time( NULL );
+
+    return true;
+}
+
+/*============================================================================*/
+U64 OSMEMORY::size()
+/*============================================================================*/
+{
+    return m_size;
+}
+
+/*============================================================================*/
+bool OSMEMORY::resize( U64 in_size )
+/*============================================================================*/
+{
+    if ( !reserve( in_size )) {
+        return false;
+    }
+
+    if ( in_size > m_size ) {
+        ::memset(( m_pData + m_size ), 0, (size_t)( in_size - m_size ));
+    }
+
+    m_size      = in_size;
+    m_timestamp = (U32)::time( NULL );
+
+    return true;
+}
+
+/*============================================================================*/
+const BYTE* OSMEMORY::view( U64 in_position,
+                            U64 in_dataSize )
+/*============================================================================*/
+{
+    if (( NULL == m_pData ) || ( in_position > m_size ) ||
+        ( in_dataSize > ( m_size - in_position ))) {
+        return NULL;
+    }
+
+    return ( m_pData + in_position );
+}
+
+/*============================================================================*/
+U32 OSMEMORY::timestamp()
+/*============================================================================*/
+{
+    return m_timestamp;
+}
+
+/*============================================================================*/
+bool OSMEMORY::reserve( U64 in_size )
+/*============================================================================*/
+{
+    if ( in_size <= m_capacity ) {
+        return true;
+    }
+
+    if ( m_region || ( in_size > U64( size_t( -1 ) / 2 ))) {
+        return false;
+    }
+
+    // Doubling keeps appends linear.
+    U64   capacity = MAX( in_size, MAX(( m_capacity * 2 ), U64( STORAGE_MINIMUM )));
+    BYTE* pData    = (BYTE*)::realloc( m_pData, (size_t)capacity );
+
+    if ( NULL == pData ) {
+        return false;
+    }
+
+    m_pData    = pData;
+    m_capacity = capacity;
+
+    return true;
+}
 
 // ---- constructor ----
 OSFIO::OSFIO()
     :
-    m_handle( ERROR ) {
+    m_handle( ERROR ),
+    m_readOnly( false ),
+    m_pMap( NULL ),
+    m_mapSize( 0 ),
+    m_position( 0 ),
+    m_pWriteBuffer( NULL ),
+    m_writeBufferSize( 0 ),
+    m_writeLength( 0 ),
+    m_writePosition( 0 ),
+    m_pRequests( NULL ),
+    m_nrOfRequests( 0 ),
+    m_allocatedRequests( 0 ),
+    m_queueDepth( 0 ),
+    m_pRing( NULL ),
+    m_pCache( NULL ),
+    m_direct( false ),
+    m_pDirectMemory( NULL ),
+    m_pDirectBuffer( NULL ),
+    m_pStorage( NULL ),
+    m_transferEnd( 0 ) {
 }
 
 // ---- destructor ----
@@ -44,21 +334,55 @@ OSFIO::~OSFIO() {
     if ( m_handle != ERROR ) {
         close();
     }
+
+    ::free( m_pWriteBuffer );
+    ::free( m_pRequests );
+    ::free( m_pDirectMemory );
 }
 
 /*============================================================================*/
 bool OSFIO::open( const STRING in_fileName,
-                  bool         in_readOnly )
+                  bool         in_readOnly,
+                  U32          in_cacheSize )
 /*============================================================================*/
 {
     if ( m_handle != ERROR ) {
         return false;
     }
 
+    resetStats();
+
+    if ( isStorageName( in_fileName )) {
+        sMOUNT* pMount = findMount( in_fileName );
+
+        if ( NULL == pMount ) {
+            return false;
+        }
+
+        // Memory is not cached, in_cacheSize is not used.
+        m_pStorage = pMount->pStorage;
+        m_handle   = STORAGE_HANDLE;
+        m_readOnly = in_readOnly;
+        m_position = 0;
+
+        return true;
+    }
+
     m_handle = ::open( in_fileName,
         (( in_readOnly ? O_RDONLY : O_RDWR ) | O_BINARY ),
         ( in_readOnly ? S_IREAD : ( S_IREAD | S_IWRITE )));
 
+    m_readOnly = in_readOnly;
+    m_position = 0;
+
+    if (( m_handle != ERROR ) && ( in_cacheSize >= CACHE_BLOCK_SIZE )) {
+        m_pCache = openCache( in_cacheSize );
+
+        if ( NULL == m_pCache ) {
+            close();
+        }
+    }
+
     return ( m_handle != ERROR );
 }
 
@@ -75,8 +399,27 @@ bool OSFIO::create( const STRING in_fileName )
         return false;
     }
 
+    if ( isStorageName( in_fileName )) {
+        OSMEMORY* pMemory = new OSMEMORY;
+
+        if (( NULL == pMemory ) || !addMount( in_fileName, pMemory, true )) {
+            delete pMemory;
+            return false;
+        }
+
+        m_pStorage = pMemory;
+        m_handle   = STORAGE_HANDLE;
+        m_readOnly = false;
+        m_position = 0;
+
+        return true;
+    }
+
     m_handle = ::open( in_fileName, ( O_CREAT | O_BINARY ), ( S_IWRITE | S_IREAD ));
 
+    m_readOnly = false;
+    m_position = 0;
+
     return ( m_handle != ERROR );
 }
 
@@ -88,9 +431,42 @@ bool OSFIO::close()
         return false;
     }
 
-    bool status_ok = ( ::close( m_handle ) != ERROR );
+    // Write buffered data before closing.
+    bool status_ok = flush();
+
+#ifdef OSFIO_LINUX
+    if (( NULL != m_pMap ) && ( NULL == m_pStorage )) {
+        ::munmap( m_pMap, m_mapSize );
+    }
+#endif
+    m_pMap    = NULL;
+    m_mapSize = 0;
+
+#ifdef OSFIO_URING
+    if ( NULL != m_pRing ) {
+        closeRing( m_pRing );
+    }
+#endif
+    m_pRing        = NULL;
+    m_queueDepth   = 0;
+
+    if ( NULL != m_pCache ) {
+        closeCache( m_pCache );
+        m_pCache = NULL;
+    }
+    m_nrOfRequests = 0; // Queued requests are discarded.
+
+    ::free( m_pWriteBuffer );
+    m_pWriteBuffer    = NULL;
+    m_writeBufferSize = 0;
+    m_direct          = false;
+
+    if ( NULL == m_pStorage ) {
+        status_ok = ( ::close( m_handle ) != ERROR ) && status_ok;
+    }
 
-    m_handle = ERROR;
+    m_pStorage = NULL;
+    m_handle   = ERROR;
 
     return status_ok;
 }
@@ -100,15 +476,11 @@ bool OSFIO::write( const POINTER in_dataPtr,
                    U32           in_dataSize )
 /*============================================================================*/
 {
-    if ( m_handle == ERROR ) {
-        return false;
-    }
-
-    return ( ::write( m_handle, in_dataPtr, in_dataSize ) != ERROR );
+    return write( m_position, in_dataPtr, in_dataSize );
 }
 
 /*============================================================================*/
-bool OSFIO::write( U32           in_position,
+bool OSFIO::write( U64           in_position,
                    const POINTER in_dataPtr,
                    U32           in_dataSize )
 /*============================================================================*/
@@ -117,28 +489,85 @@ bool OSFIO::write( U32           in_position,
         return false;
     }
 
-    bool eof_position = ( in_position == EOF_POSITION );
+    if ( in_position == EOF_POSITION ) {
+        in_position = size();
+
+        if ( in_position == (U64)INVALID_VALUE ) {
+            return false;
+        }
+    }
+
+    bool status_ok;
+
+    if ( NULL == m_pWriteBuffer ) {
+        status_ok = writeAt( in_position, in_dataPtr, in_dataSize );
+    } else {
+        status_ok = bufferWrite( in_position, in_dataPtr, in_dataSize );
+    }
+
+    if ( status_ok ) {
+        m_position = in_position + in_dataSize;
+    }
 
-    return (( ::lseek( m_handle,
-                       ( eof_position ? 0 : in_position ),
-                       ( eof_position ? SEEK_END : SEEK_SET )) != ERROR ) &&
-            ( ::write( m_handle, in_dataPtr, in_dataSize ) != ERROR ));
+    return status_ok;
 }
 
 /*============================================================================*/
-bool OSFIO::read( POINTER out_dataPtr,
-                  U32     in_dataSize )
+bool OSFIO::write( U64               in_position,
+                   const sIO_VECTOR* in_pVector,
+                   U32               in_count )
 /*============================================================================*/
 {
     if ( m_handle == ERROR ) {
         return false;
     }
 
-    return ( (U32)::read( m_handle, out_dataPtr, in_dataSize ) == in_dataSize );
+    if ( in_position == EOF_POSITION ) {
+        in_position = size();
+
+        if ( in_position == (U64)INVALID_VALUE ) {
+            return false;
+        }
+    }
+
+    U64 totalSize = 0;
+
+    for ( U32 i = 0; i < in_count; i++ ) {
+        totalSize += in_pVector[ i ].dataSize;
+    }
+
+    bool status_ok = true;
+
+    if (( NULL != m_pWriteBuffer ) && ( totalSize < m_writeBufferSize )) {
+        // Small pieces are merged in the buffer.
+        U64 position = in_position;
+
+        for ( U32 i = 0; status_ok && ( i < in_count ); i++ ) {
+            status_ok = bufferWrite( position, in_pVector[ i ].pData,
+                                     in_pVector[ i ].dataSize );
+            position += in_pVector[ i ].dataSize;
+        }
+    } else {
+        status_ok = flush() && writeAt( in_position, in_pVector, in_count );
+    }
+
+    if ( status_ok ) {
+        m_position = in_position + totalSize;
+    }
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool OSFIO::read( POINTER out_dataPtr,
+                  U32     in_dataSize )
+/*============================================================================*/
+{
+    return read( m_position, out_dataPtr, in_dataSize );
 }
 
 /*============================================================================*/
-bool OSFIO::read( U32     in_position,
+bool OSFIO::read( U64     in_position,
                   POINTER out_dataPtr,
                   U32     in_dataSize )
 /*============================================================================*/
@@ -147,9 +576,42 @@ bool OSFIO::read( U32     in_position,
         return false;
     }
 
-    return (( ::lseek( m_handle, in_position, SEEK_SET ) != ERROR ) &&
-            ( (U32)::read( m_handle, out_dataPtr, in_dataSize ) ==
-              in_dataSize ));
+    // Buffered data overlapping the read range is written first.
+    if (( m_writeLength > 0 ) &&
+        ( in_position < ( m_writePosition + m_writeLength )) &&
+        (( in_position + in_dataSize ) > m_writePosition )) {
+        if ( !flush() ) {
+            return false;
+        }
+    }
+
+    const BYTE* pMapped = view( in_position, in_dataSize );
+
+    if ( NULL != pMapped ) {
+        ::memcpy( out_dataPtr, pMapped, in_dataSize );
+        m_position = in_position + in_dataSize;
+        return true;
+    }
+
+    // Large reads bypass the cache, they would evict too many blocks.
+    if (( NULL != m_pCache ) &&
+        ( in_dataSize <= (( U64( m_pCache->nrOfBlocks ) * CACHE_BLOCK_SIZE ) / 4 ))) {
+        bool status_ok = cacheRead( in_position, (BYTE*)out_dataPtr, in_dataSize );
+
+        if ( status_ok ) {
+            m_position = in_position + in_dataSize;
+        }
+
+        return status_ok;
+    }
+
+    S64 bytesRead = readAt( in_position, out_dataPtr, in_dataSize );
+
+    if ( bytesRead >= 0 ) {
+        m_position = in_position + (U64)bytesRead;
+    }
+
+    return ( bytesRead == S64( in_dataSize ));
 }
 
 /*============================================================================*/
@@ -160,39 +622,89 @@ bool OSFIO::eof()
         return false;
     }
 
-    return ( ::eof( m_handle ) == 1 );
+    U64 fileSize = size();
+
+    return (( fileSize != (U64)INVALID_VALUE ) && ( m_position >= fileSize ));
 }
 
 /*============================================================================*/
-U32 OSFIO::size()
+U64 OSFIO::size()
 /*============================================================================*/
 {
-    return (U32)::filelength( m_handle );
+    if ( m_handle == ERROR ) {
+        return (U64)INVALID_VALUE;
+    }
+
+    U64 fileSize = (U64)INVALID_VALUE;
+
+    if ( NULL != m_pStorage ) {
+        fileSize = m_pStorage->size();
+    } else {
+        m_stats.otherCalls++;
+#ifdef OSFIO_LINUX
+        struct stat statBuffer;
+
+        if ( ::fstat( m_handle, &statBuffer ) == 0 ) {
+            fileSize = (U64)statBuffer.st_size;
+        }
+#else
+        fileSize = (U64)FILELENGTH( m_handle );
+#endif
+    }
+
+    // Buffered data could extend the file.
+    if (( fileSize != (U64)INVALID_VALUE ) && ( m_writeLength > 0 )) {
+        fileSize = MAX( fileSize, ( m_writePosition + m_writeLength ));
+    }
+
+    return fileSize;
 }
 
 /*============================================================================*/
-U32 OSFIO::position()
+U64 OSFIO::position()
 /*============================================================================*/
 {
-    return (U32)::tell( m_handle );
+    if ( m_handle == ERROR ) {
+        return (U64)INVALID_VALUE;
+    }
+
+    return m_position;
 }
 
 /*============================================================================*/
-bool OSFIO::truncate( U32 in_position )
+bool OSFIO::truncate( U64 in_position )
 /*============================================================================*/
 {
     if ( m_handle == ERROR ) {
         return false;
     }
 
-    U32  fileSize  = size();
-    bool status_ok = ( fileSize != (U32)INVALID_VALUE );
+    bool status_ok = flush();
+    U64  fileSize  = size();
+
+    if ( NULL != m_pCache ) {
+        invalidateBlocks( m_pCache, in_position, ( fileSize - in_position ));
+    }
+
+    status_ok = status_ok && ( fileSize != (U64)INVALID_VALUE );
 
     if ( status_ok ) {
         status_ok = ( in_position < fileSize );
-        status_ok = status_ok && ( ::chsize( m_handle, in_position ) != ERROR );
+
+        if ( NULL != m_pStorage ) {
+            status_ok = status_ok && !m_readOnly && m_pStorage->resize( in_position );
+        } else {
+            m_stats.otherCalls++;
+#ifdef OSFIO_LINUX
+            status_ok = status_ok && ( ::ftruncate( m_handle, in_position ) != ERROR );
+#else
+            status_ok = status_ok && ( CHSIZE( m_handle, in_position ) != ERROR );
+#endif
+        }
         // set file pointer correct
-        status_ok = status_ok && ( ::lseek( m_handle, 0, SEEK_END ) != ERROR );
+        if ( status_ok ) {
+            m_position = in_position;
+        }
     }
 
     return status_ok;
@@ -202,8 +714,14 @@ bool OSFIO::truncate( U32 in_position )
 U32 OSFIO::timestamp()
 /*============================================================================*/
 {
+    if ( NULL != m_pStorage ) {
+        return m_pStorage->timestamp();
+    }
+
     struct stat statBuffer;
 
+    m_stats.otherCalls++;
+
     if ( ::fstat( m_handle, &statBuffer ) == 0 ) {
         return (U32)statBuffer.st_mtime;
     }
@@ -212,11 +730,1305 @@ U32 OSFIO::timestamp()
 }
 
 /*============================================================================*/
-bool OSFIO::erase( const STRING in_fileName )
+bool OSFIO::map()
 /*============================================================================*/
 {
-    // Allow to delete. Might be read-only.
-    ::chmod( in_fileName, ( S_IWRITE | S_IREAD ));
+    if (( m_handle == ERROR ) || !m_readOnly ) {
+        return false;
+    }
 
-    return ( ::remove( in_fileName ) == SUCCESSFUL );
+    if ( NULL != m_pMap ) {
+        return true;
+    }
+
+    if ( NULL != m_pStorage ) {
+        // Memory is viewed directly, nothing is mapped.
+        m_mapSize = m_pStorage->size();
+        m_pMap    = (BYTE*)m_pStorage->view( 0, m_mapSize );
+
+        return ( NULL != m_pMap );
+    }
+
+#ifdef OSFIO_LINUX
+    U64 fileSize = size();
+
+    if (( fileSize == (U64)INVALID_VALUE ) || ( fileSize == 0 )) {
+        return false;
+    }
+
+    void* pMap = ::mmap( NULL, fileSize, PROT_READ, MAP_SHARED, m_handle, 0 );
+
+    if ( pMap == MAP_FAILED ) {
+        return false;
+    }
+
+    m_pMap    = (BYTE*)pMap;
+    m_mapSize = fileSize;
+
+    return true;
+#else
+    return false; // Not supported, system calls are used.
+#endif
+}
+
+/*============================================================================*/
+const BYTE* OSFIO::view( U64 in_position,
+                         U32 in_dataSize )
+/*============================================================================*/
+{
+    if (( NULL == m_pMap ) || ( in_position > m_mapSize ) ||
+        ( in_dataSize > ( m_mapSize - in_position ))) {
+        return NULL;
+    }
+
+    return ( m_pMap + in_position );
+}
+
+/*============================================================================*/
+bool OSFIO::setWriteBuffer( U32 in_bufferSize )
+/*============================================================================*/
+{
+    if (( m_handle == ERROR ) || m_readOnly ) {
+        return false;
+    }
+
+    if ( !flush() ) {
+        return false;
+    }
+
+    if ( NULL != m_pStorage ) {
+        return true; // Writes to memory are not buffered.
+    }
+
+    ::free( m_pWriteBuffer );
+    m_pWriteBuffer    = NULL;
+    m_writeBufferSize = 0;
+
+    if ( in_bufferSize > 0 ) {
+        m_pWriteBuffer = (BYTE*)::malloc( in_bufferSize );
+
+        if ( NULL == m_pWriteBuffer ) {
+            return false;
+        }
+
+        m_writeBufferSize = in_bufferSize;
+    }
+
+    return true;
+}
+
+/*============================================================================*/
+bool OSFIO::flush()
+/*============================================================================*/
+{
+    if ( m_writeLength == 0 ) {
+        return true;
+    }
+
+    bool status_ok = writeAt( m_writePosition, m_pWriteBuffer, m_writeLength );
+
+    m_writeLength = 0; // Data is lost if the write failed.
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool OSFIO::sync()
+/*============================================================================*/
+{
+    if ( m_handle == ERROR ) {
+        return false;
+    }
+
+    bool status_ok = flush();
+
+    if ( NULL != m_pStorage ) {
+        return status_ok; // Memory is not persistent.
+    }
+
+    m_stats.otherCalls++;
+
+#ifdef OSFIO_LINUX
+    return ( ::fdatasync( m_handle ) != ERROR ) && status_ok;
+#elif defined( _MSC_VER )
+    return ( ::_commit( m_handle ) != ERROR ) && status_ok;
+#else
+    return ( ::fsync( m_handle ) != ERROR ) && status_ok;
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::advise( eADVICE in_advice,
+                    U64     in_position,
+                    U64     in_size )
+/*============================================================================*/
+{
+    if (( m_handle == ERROR ) || ( in_advice > ADVICE_DONTNEED )) {
+        return false;
+    }
+
+    if ( NULL != m_pStorage ) {
+        return true; // Memory is not read ahead.
+    }
+
+#ifdef OSFIO_LINUX
+    static const int aFileAdvice[] = {
+        POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM,
+        POSIX_FADV_WILLNEED, POSIX_FADV_DONTNEED
+    };
+    static const int aMapAdvice[] = {
+        MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED
+    };
+
+    m_stats.otherCalls++;
+
+    bool status_ok = ( ::posix_fadvise( m_handle, (off_t)in_position, (off_t)in_size,
+                                        aFileAdvice[ in_advice ] ) == SUCCESSFUL );
+
+    // Page faults of a mapping are read ahead by its own advice.
+    if (( NULL != m_pMap ) && ( in_position < m_mapSize )) {
+        U64 pageSize = U64( ::sysconf( _SC_PAGESIZE ));
+        U64 start    = in_position - ( in_position % pageSize );
+        U64 end      = (( in_size == 0 ) || ( in_size > ( m_mapSize - in_position ))) ?
+                       m_mapSize : ( in_position + in_size );
+
+        m_stats.otherCalls++;
+        status_ok = ( ::madvise(( m_pMap + start ), size_t( end - start ),
+                                aMapAdvice[ in_advice ] ) == SUCCESSFUL ) && status_ok;
+    }
+
+    return status_ok;
+#else
+    return false; // Not supported.
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::allocate( U64 in_position,
+                      U64 in_size )
+/*============================================================================*/
+{
+    if (( m_handle == ERROR ) || m_readOnly ) {
+        return false;
+    }
+
+    if ( NULL != m_pStorage ) {
+        U64 end = in_position + in_size;
+
+        return (( end <= m_pStorage->size()) || m_pStorage->resize( end ));
+    }
+
+    m_stats.otherCalls++;
+
+#ifdef OSFIO_LINUX
+    return ( ::fallocate( m_handle, 0, (off_t)in_position, (off_t)in_size ) != ERROR );
+#else
+    return false; // Not supported, the file grows by writes.
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::setDirectIO( bool in_direct )
+/*============================================================================*/
+{
+    if (( m_handle == ERROR ) || !flush() ) {
+        return false;
+    }
+
+    if ( NULL != m_pStorage ) {
+        return !in_direct; // No page cache to bypass.
+    }
+
+#ifdef OSFIO_LINUX
+    if (( O_DIRECT == 0 ) || ( in_direct == m_direct )) {
+        return ( in_direct == m_direct );
+    }
+
+    if ( in_direct && ( NULL == m_pDirectMemory )) {
+        m_pDirectMemory = (BYTE*)::malloc( DIRECT_BUFFER_SIZE + DIRECT_ALIGNMENT );
+
+        if ( NULL == m_pDirectMemory ) {
+            return false;
+        }
+
+        m_pDirectBuffer = (BYTE*)ALIGN_UP( size_t( m_pDirectMemory ));
+    }
+
+    int flags = ::fcntl( m_handle, F_GETFL );
+
+    if ( flags == ERROR ) {
+        return false;
+    }
+
+    flags = in_direct ? ( flags | O_DIRECT ) : ( flags & ~O_DIRECT );
+
+    if ( ::fcntl( m_handle, F_SETFL, flags ) == ERROR ) {
+        return false; // Not supported by the file system.
+    }
+
+    m_direct = in_direct;
+
+    return true;
+#else
+    return !in_direct; // Not supported.
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::setQueueDepth( U32 in_queueDepth )
+/*============================================================================*/
+{
+    if (( m_handle == ERROR ) || ( m_nrOfRequests > 0 )) {
+        return false;
+    }
+
+#ifdef OSFIO_URING
+    if ( NULL != m_pRing ) {
+        closeRing( m_pRing );
+        m_pRing = NULL;
+    }
+#endif
+
+    m_queueDepth = in_queueDepth;
+
+    return true;
+}
+
+/*============================================================================*/
+bool OSFIO::queueRead( U64     in_position,
+                       POINTER out_dataPtr,
+                       U32     in_dataSize )
+/*============================================================================*/
+{
+    return queue( in_position, (BYTE*)out_dataPtr, in_dataSize, false );
+}
+
+/*============================================================================*/
+bool OSFIO::queueWrite( U64           in_position,
+                        const POINTER in_dataPtr,
+                        U32           in_dataSize )
+/*============================================================================*/
+{
+    if ( m_readOnly ) {
+        return false;
+    }
+
+    return queue( in_position, (BYTE*)in_dataPtr, in_dataSize, true );
+}
+
+/*============================================================================*/
+bool OSFIO::submit()
+/*============================================================================*/
+{
+    if ( m_handle == ERROR ) {
+        return false;
+    }
+
+    // Queued reads could overlap buffered data.
+    bool status_ok = flush();
+
+    for ( U32 i = 0; ( NULL != m_pCache ) && ( i < m_nrOfRequests ); i++ ) {
+        if ( m_pRequests[ i ].write ) {
+            invalidateBlocks( m_pCache, m_pRequests[ i ].position, m_pRequests[ i ].dataSize );
+        }
+    }
+
+#ifdef OSFIO_URING
+    // Mapped files and storages are accessed without system calls. Direct
+    // I/O is aligned by synchronous execution.
+    if (( NULL == m_pRing ) && ( m_queueDepth > 0 ) && ( NULL == m_pMap ) &&
+        ( NULL == m_pStorage ) && !m_direct && ( m_nrOfRequests > 1 )) {
+        m_pRing = openRing( m_queueDepth );
+
+        if ( NULL == m_pRing ) {
+            m_queueDepth = 0; // Not supported, executed synchronously.
+        }
+    }
+
+    if (( NULL != m_pRing ) && ( NULL == m_pMap ) && !m_direct ) {
+        status_ok = submitRing() && status_ok;
+    } else
+#endif
+    {
+        for ( U32 i = 0; i < m_nrOfRequests; i++ ) {
+            status_ok = execute( m_pRequests[ i ] ) && status_ok;
+        }
+    }
+
+    m_nrOfRequests = 0;
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool OSFIO::getCacheStats( sCACHE_STATS& out_rStats )
+/*============================================================================*/
+{
+    if ( NULL == m_pCache ) {
+        return false;
+    }
+
+    out_rStats = m_pCache->stats;
+
+    return true;
+}
+
+/*============================================================================*/
+void OSFIO::getStats( sIO_STATS& out_rStats )
+/*============================================================================*/
+{
+    out_rStats = m_stats;
+}
+
+/*============================================================================*/
+void OSFIO::resetStats()
+/*============================================================================*/
+{
+    m_stats       = sIO_STATS();
+    m_transferEnd = 0;
+}
+
+/*============================================================================*/
+bool OSFIO::erase( const STRING in_fileName )
+/*============================================================================*/
+{
+    if ( isStorageName( in_fileName )) {
+        for ( sMOUNT** ppMount = &pMountListEntry; NULL != *ppMount;
+              ppMount = &( *ppMount )->pNext ) {
+            sMOUNT* pMount = *ppMount;
+
+            if ( ::strcmp( pMount->pName, in_fileName ) == 0 ) {
+                *ppMount = pMount->pNext;
+
+                if ( pMount->owned ) {
+                    delete pMount->pStorage;
+                }
+
+                ::free( pMount->pName );
+                ::free( pMount );
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Allow to delete. Might be read-only.
+    ::chmod( in_fileName, ( S_IWRITE | S_IREAD ));
+
+    return ( ::remove( in_fileName ) == SUCCESSFUL );
+}
+
+/*============================================================================*/
+bool OSFIO::mount( const STRING in_name,
+                   OSSTORAGE*   in_pStorage )
+/*============================================================================*/
+{
+    return ( isStorageName( in_name ) && ( NULL != in_pStorage ) &&
+             addMount( in_name, in_pStorage, false ));
+}
+
+/*============================================================================*/
+bool OSFIO::bufferWrite( U64           in_position,
+                         const POINTER in_dataPtr,
+                         U32           in_dataSize )
+/*============================================================================*/
+{
+    // Merge if the data is adjacent to or inside the buffered range and fits.
+    bool merge = (( m_writeLength > 0 ) &&
+                  ( in_position >= m_writePosition ) &&
+                  ( in_position <= ( m_writePosition + m_writeLength )) &&
+                  (( in_position + in_dataSize - m_writePosition ) <= m_writeBufferSize ));
+
+    if ( !merge ) {
+        if ( !flush() ) {
+            return false;
+        }
+
+        if ( in_dataSize >= m_writeBufferSize ) {
+            return writeAt( in_position, in_dataPtr, in_dataSize );
+        }
+
+        m_writePosition = in_position;
+    }
+
+    U32 offset = U32( in_position - m_writePosition );
+
+    ::memcpy(( m_pWriteBuffer + offset ), in_dataPtr, in_dataSize );
+    m_writeLength = MAX( m_writeLength, ( offset + in_dataSize ));
+
+    return true;
+}
+
+/*============================================================================*/
+S64 OSFIO::readAt( U64     in_position,
+                   POINTER out_dataPtr,
+                   U32     in_dataSize )
+/*============================================================================*/
+{
+    U64 startTime = clockTime();
+    S64 bytesRead = ERROR;
+
+    if ( NULL != m_pStorage ) {
+        bytesRead = m_pStorage->read( in_position, out_dataPtr, in_dataSize );
+    } else {
+#ifdef OSFIO_LINUX
+        if ( m_direct ) {
+            bytesRead = directRead( in_position, (BYTE*)out_dataPtr, in_dataSize );
+        } else {
+            bytesRead = (S64)::pread( m_handle, out_dataPtr, in_dataSize, (off_t)in_position );
+        }
+#else
+        if ( LSEEK( m_handle, in_position, SEEK_SET ) != ERROR ) {
+            bytesRead = (S64)::read( m_handle, out_dataPtr, in_dataSize );
+        }
+#endif
+    }
+
+    account( false, in_position, bytesRead, startTime );
+
+    return bytesRead;
+}
+
+/*============================================================================*/
+bool OSFIO::writeAt( U64           in_position,
+                     const POINTER in_dataPtr,
+                     U32           in_dataSize )
+/*============================================================================*/
+{
+    if ( NULL != m_pCache ) {
+        invalidateBlocks( m_pCache, in_position, in_dataSize );
+    }
+
+    U64  startTime = clockTime();
+    bool status_ok;
+
+    if ( NULL != m_pStorage ) {
+        status_ok = !m_readOnly && m_pStorage->write( in_position, in_dataPtr, in_dataSize );
+    } else {
+#ifdef OSFIO_LINUX
+        if ( m_direct ) {
+            sIO_VECTOR vector = { in_dataPtr, in_dataSize };
+
+            status_ok = directWrite( in_position, &vector, 1 );
+        } else {
+            status_ok = ( ::pwrite( m_handle, in_dataPtr, in_dataSize, (off_t)in_position ) ==
+                          (ssize_t)in_dataSize );
+        }
+#else
+        status_ok = (( LSEEK( m_handle, in_position, SEEK_SET ) != ERROR ) &&
+                     ( (U32)::write( m_handle, in_dataPtr, in_dataSize ) == in_dataSize ));
+#endif
+    }
+
+    account( true, in_position, ( status_ok ? S64( in_dataSize ) : ERROR ), startTime );
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool OSFIO::writeAt( U64               in_position,
+                     const sIO_VECTOR* in_pVector,
+                     U32               in_count )
+/*============================================================================*/
+{
+    bool status_ok = true;
+    U64  totalSize = 0;
+
+    for ( U32 i = 0; i < in_count; i++ ) {
+        totalSize += in_pVector[ i ].dataSize;
+    }
+
+    if ( NULL != m_pCache ) {
+        invalidateBlocks( m_pCache, in_position, totalSize );
+    }
+
+    if ( NULL != m_pStorage ) {
+        for ( U32 i = 0; status_ok && ( i < in_count ); i++ ) {
+            status_ok    = writeAt( in_position, in_pVector[ i ].pData, in_pVector[ i ].dataSize );
+            in_position += in_pVector[ i ].dataSize;
+        }
+
+        return status_ok;
+    }
+
+#ifdef OSFIO_LINUX
+    if ( m_direct ) {
+        U64 startTime = clockTime();
+
+        status_ok = directWrite( in_position, in_pVector, in_count );
+        account( true, in_position, ( status_ok ? S64( totalSize ) : ERROR ), startTime );
+
+        return status_ok;
+    }
+
+    struct iovec aVector[ IO_VECTOR_CHUNK ];
+
+    while ( status_ok && ( in_count > 0 )) {
+        U32 count     = MIN( in_count, U32( IO_VECTOR_CHUNK ));
+        U64 chunkSize = 0;
+
+        for ( U32 i = 0; i < count; i++ ) {
+            aVector[ i ].iov_base = (void*)in_pVector[ i ].pData;
+            aVector[ i ].iov_len  = in_pVector[ i ].dataSize;
+            chunkSize += in_pVector[ i ].dataSize;
+        }
+
+        U64     startTime = clockTime();
+        ssize_t written   = ::pwritev( m_handle, aVector, count, (off_t)in_position );
+
+        account( true, in_position, S64( written ), startTime );
+
+        status_ok = ( written >= 0 );
+
+        if ( status_ok && ( U64( written ) < chunkSize )) {
+            // Rare partial write, the rest is written piece by piece.
+            U64 offset = 0;
+
+            for ( U32 i = 0; status_ok && ( i < count ); i++ ) {
+                U32 pieceSize = in_pVector[ i ].dataSize;
+
+                if (( offset + pieceSize ) > U64( written )) {
+                    U32 skip = ( U64( written ) > offset ) ? U32( written - offset ) : 0;
+
+                    status_ok = writeAt(( in_position + offset + skip ),
+                                        ( (const BYTE*)in_pVector[ i ].pData + skip ),
+                                        ( pieceSize - skip ));
+                }
+
+                offset += pieceSize;
+            }
+        }
+
+        in_position += chunkSize;
+        in_pVector  += count;
+        in_count    -= count;
+    }
+#else
+    for ( U32 i = 0; status_ok && ( i < in_count ); i++ ) {
+        status_ok    = writeAt( in_position, in_pVector[ i ].pData, in_pVector[ i ].dataSize );
+        in_position += in_pVector[ i ].dataSize;
+    }
+#endif
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool OSFIO::queue( U64   in_position,
+                   BYTE* in_pData,
+                   U32   in_dataSize,
+                   bool  in_write )
+/*============================================================================*/
+{
+    if ( m_handle == ERROR ) {
+        return false;
+    }
+
+    if ( m_nrOfRequests == m_allocatedRequests ) {
+        U32 allocatedRequests = ( m_allocatedRequests == 0 ) ? QUEUE_CHUNK :
+                                ( 2 * m_allocatedRequests );
+        sIO_REQUEST* pRequests = (sIO_REQUEST*)::realloc( m_pRequests,
+                                 ( allocatedRequests * sizeof( sIO_REQUEST )));
+
+        if ( NULL == pRequests ) {
+            return false;
+        }
+
+        m_pRequests         = pRequests;
+        m_allocatedRequests = allocatedRequests;
+    }
+
+    sIO_REQUEST& request = m_pRequests[ m_nrOfRequests++ ];
+
+    request.position = in_position;
+    request.pData    = in_pData;
+    request.dataSize = in_dataSize;
+    request.write    = in_write;
+
+    return true;
+}
+
+/*============================================================================*/
+bool OSFIO::execute( const sIO_REQUEST& in_rRequest )
+/*============================================================================*/
+{
+    if ( in_rRequest.write ) {
+        return writeAt( in_rRequest.position, in_rRequest.pData, in_rRequest.dataSize );
+    }
+
+    const BYTE* pMapped = view( in_rRequest.position, in_rRequest.dataSize );
+
+    if ( NULL != pMapped ) {
+        ::memcpy( in_rRequest.pData, pMapped, in_rRequest.dataSize );
+        return true;
+    }
+
+    return ( readAt( in_rRequest.position, in_rRequest.pData, in_rRequest.dataSize ) ==
+             S64( in_rRequest.dataSize ));
+}
+
+/*============================================================================*/
+bool OSFIO::submitRing()
+/*============================================================================*/
+{
+#ifdef OSFIO_URING
+    bool status_ok = true;
+    U32  next      = 0;
+
+    while ( next < m_nrOfRequests ) {
+        U32      count = MIN(( m_nrOfRequests - next ), m_pRing->entries );
+        unsigned tail  = *m_pRing->pSqTail; // Only written by this process.
+
+        for ( U32 i = 0; i < count; i++ ) {
+            const sIO_REQUEST& request = m_pRequests[ next + i ];
+            unsigned           entry   = tail & *m_pRing->pSqMask;
+            io_uring_sqe*      pSqe    = &m_pRing->pSqes[ entry ];
+
+            ::memset( pSqe, 0, sizeof( *pSqe ));
+            pSqe->opcode    = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+            pSqe->fd        = m_handle;
+            pSqe->off       = request.position;
+            pSqe->addr      = (unsigned long)request.pData;
+            pSqe->len       = request.dataSize;
+            pSqe->user_data = next + i;
+
+            m_pRing->pSqArray[ entry ] = entry;
+            tail++;
+        }
+
+        __atomic_store_n( m_pRing->pSqTail, tail, __ATOMIC_RELEASE );
+
+        U64 startTime = clockTime();
+        U32 submitted = 0;
+        U32 completed = 0;
+
+        while ( completed < count ) {
+            m_stats.otherCalls++;
+
+            long result = ::syscall( __NR_io_uring_enter, m_pRing->fd,
+                                     ( count - submitted ), ( count - completed ),
+                                     IORING_ENTER_GETEVENTS, NULL, 0 );
+
+            if ( result < 0 ) {
+                if ( errno == EINTR ) {
+                    continue;
+                }
+
+                // Broken queue, the remaining requests are executed synchronously.
+                closeRing( m_pRing );
+                m_pRing      = NULL;
+                m_queueDepth = 0;
+
+                for ( U32 i = next; i < m_nrOfRequests; i++ ) {
+                    status_ok = execute( m_pRequests[ i ] ) && status_ok;
+                }
+
+                return status_ok;
+            }
+
+            submitted += U32( result );
+
+            unsigned head    = *m_pRing->pCqHead;
+            unsigned cqeTail = __atomic_load_n( m_pRing->pCqTail, __ATOMIC_ACQUIRE );
+
+            while ( head != cqeTail ) {
+                const io_uring_cqe* pCqe = &m_pRing->pCqes[ head & *m_pRing->pCqMask ];
+                const sIO_REQUEST& request = m_pRequests[ pCqe->user_data ];
+
+                account( request.write, request.position, S64( pCqe->res ), startTime );
+
+                // Failed or partial transfers are repeated synchronously.
+                if ( pCqe->res != S32( request.dataSize )) {
+                    status_ok = execute( request ) && status_ok;
+                }
+
+                head++;
+                completed++;
+            }
+
+            __atomic_store_n( m_pRing->pCqHead, head, __ATOMIC_RELEASE );
+        }
+
+        next += count;
+    }
+
+    return status_ok;
+#else
+    return false;
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::cacheRead( U64   in_position,
+                       BYTE* out_pData,
+                       U32   in_dataSize )
+/*============================================================================*/
+{
+    while ( in_dataSize > 0 ) {
+        U64   blockNr = in_position / CACHE_BLOCK_SIZE;
+        U32   offset  = U32( in_position % CACHE_BLOCK_SIZE );
+        U32   length  = MIN( in_dataSize, ( CACHE_BLOCK_SIZE - offset ));
+        U32   block   = findBlock( m_pCache, blockNr );
+
+        if ( block == NO_BLOCK ) {
+            m_pCache->stats.misses++;
+            block = allocateBlock( m_pCache );
+
+            BYTE* pBlockData = m_pCache->pData + ( U64( block ) * CACHE_BLOCK_SIZE );
+            S64   bytesRead  = readAt(( blockNr * CACHE_BLOCK_SIZE ), pBlockData,
+                                      CACHE_BLOCK_SIZE );
+
+            if ( bytesRead == S64( CACHE_BLOCK_SIZE )) {
+                insertBlock( m_pCache, block, blockNr );
+            } else {
+                // Last block of the file is not cached, it could grow.
+                releaseBlock( m_pCache, block );
+
+                if ( bytesRead < S64( offset + length )) {
+                    return false;
+                }
+
+                ::memcpy( out_pData, ( pBlockData + offset ), length );
+                block = NO_BLOCK;
+            }
+        } else {
+            m_pCache->stats.hits++;
+        }
+
+        if ( block != NO_BLOCK ) {
+            ::memcpy( out_pData, ( m_pCache->pData + ( U64( block ) * CACHE_BLOCK_SIZE ) + offset ),
+                      length );
+        }
+
+        in_position += length;
+        out_pData   += length;
+        in_dataSize -= length;
+    }
+
+    return true;
+}
+
+/*============================================================================*/
+S64 OSFIO::directRead( U64   in_position,
+                       BYTE* out_pData,
+                       U32   in_dataSize )
+/*============================================================================*/
+{
+#ifdef OSFIO_LINUX
+    // Aligned requests are read without the aligned buffer.
+    if ((( in_position | in_dataSize | size_t( out_pData )) % DIRECT_ALIGNMENT ) == 0 ) {
+        return (S64)::pread( m_handle, out_pData, in_dataSize, (off_t)in_position );
+    }
+
+    U32 done = 0;
+
+    while ( done < in_dataSize ) {
+        U64     position     = in_position + done;
+        U64     alignedStart = ALIGN_DOWN( position );
+        U32     length       = U32( MIN(( ALIGN_UP( in_position + in_dataSize ) - alignedStart ),
+                                        U64( DIRECT_BUFFER_SIZE )));
+        ssize_t bytesRead    = ::pread( m_handle, m_pDirectBuffer, length, (off_t)alignedStart );
+
+        if ( bytesRead < 0 ) {
+            return ERROR;
+        }
+
+        U32 skip = U32( position - alignedStart );
+
+        if ( U64( bytesRead ) <= skip ) {
+            break; // End of file.
+        }
+
+        U32 count = MIN(( U32( bytesRead ) - skip ), ( in_dataSize - done ));
+
+        ::memcpy(( out_pData + done ), ( m_pDirectBuffer + skip ), count );
+        done += count;
+
+        if ( U32( bytesRead ) < length ) {
+            break; // End of file.
+        }
+    }
+
+    return S64( done );
+#else
+    return ERROR;
+#endif
+}
+
+/*============================================================================*/
+bool OSFIO::directWrite( U64               in_position,
+                         const sIO_VECTOR* in_pVector,
+                         U32               in_count )
+/*============================================================================*/
+{
+#ifdef OSFIO_LINUX
+    struct stat statBuffer;
+
+    if ( ::fstat( m_handle, &statBuffer ) != 0 ) {
+        return false;
+    }
+
+    U64 fileSize = U64( statBuffer.st_size );
+    U64 end      = in_position;
+
+    for ( U32 i = 0; i < in_count; i++ ) {
+        end += in_pVector[ i ].dataSize;
+    }
+
+    // Aligned single piece is written without the aligned buffer.
+    if (( in_count == 1 ) &&
+        ((( in_position | end | size_t( in_pVector[ 0 ].pData )) % DIRECT_ALIGNMENT ) == 0 )) {
+        return ( ::pwrite( m_handle, in_pVector[ 0 ].pData, in_pVector[ 0 ].dataSize,
+                           (off_t)in_position ) == (ssize_t)in_pVector[ 0 ].dataSize );
+    }
+
+    bool status_ok   = true;
+    U64  position    = in_position;
+    U32  piece       = 0;
+    U32  pieceOffset = 0;
+
+    while ( status_ok && ( position < end )) {
+        U64 alignedStart = ALIGN_DOWN( position );
+        U64 alignedEnd   = MIN(( alignedStart + DIRECT_BUFFER_SIZE ), ALIGN_UP( end ));
+        U64 chunkEnd     = MIN( alignedEnd, end );
+        U32 length       = U32( alignedEnd - alignedStart );
+
+        // Read-modify-write of partial first and last block.
+        if ( position > alignedStart ) {
+            ::memset( m_pDirectBuffer, 0, DIRECT_ALIGNMENT );
+            status_ok = ( alignedStart >= fileSize ) ||
+                        ( ::pread( m_handle, m_pDirectBuffer, DIRECT_ALIGNMENT,
+                                   (off_t)alignedStart ) >= 0 );
+        }
+
+        U64 lastBlock = alignedEnd - DIRECT_ALIGNMENT;
+
+        if ( status_ok && ( chunkEnd < alignedEnd ) &&
+             (( lastBlock > alignedStart ) || ( position == alignedStart ))) {
+            BYTE* pLast = m_pDirectBuffer + ( lastBlock - alignedStart );
+
+            ::memset( pLast, 0, DIRECT_ALIGNMENT );
+            status_ok = ( lastBlock >= fileSize ) ||
+                        ( ::pread( m_handle, pLast, DIRECT_ALIGNMENT, (off_t)lastBlock ) >= 0 );
+        }
+
+        // Gather the data pieces of this chunk.
+        for ( U64 copied = position; status_ok && ( copied < chunkEnd ); ) {
+            U32 count = U32( MIN( U64( in_pVector[ piece ].dataSize - pieceOffset ),
+                                  ( chunkEnd - copied )));
+
+            ::memcpy(( m_pDirectBuffer + ( copied - alignedStart )),
+                     ( (const BYTE*)in_pVector[ piece ].pData + pieceOffset ), count );
+            copied      += count;
+            pieceOffset += count;
+
+            if ( pieceOffset == in_pVector[ piece ].dataSize ) {
+                piece++;
+                pieceOffset = 0;
+            }
+        }
+
+        status_ok = status_ok &&
+                    ( ::pwrite( m_handle, m_pDirectBuffer, length, (off_t)alignedStart ) ==
+                      (ssize_t)length );
+        position  = chunkEnd;
+    }
+
+    // The aligned write could extend the file beyond its logical size.
+    if ( status_ok && ( ALIGN_UP( end ) > MAX( fileSize, end ))) {
+        status_ok = ( ::ftruncate( m_handle, (off_t)MAX( fileSize, end )) != ERROR );
+    }
+
+    return status_ok;
+#else
+    return false;
+#endif
+}
+
+/*============================================================================*/
+void OSFIO::account( bool in_write,
+                     U64  in_position,
+                     S64  in_result,
+                     U64  in_startTime )
+/*============================================================================*/
+{
+    U64 elapsed  = ( clockTime() - in_startTime ) / 1000; // Microseconds.
+    U64 dataSize = ( in_result > 0 ) ? U64( in_result ) : 0;
+    U32 bucket   = 0;
+
+    while (( elapsed > 0 ) && ( bucket < ( LATENCY_BUCKETS - 1 ))) {
+        elapsed >>= 1;
+        bucket++;
+    }
+
+    m_stats.seekDistance += ( in_position > m_transferEnd ) ? ( in_position - m_transferEnd ) :
+                                                              ( m_transferEnd - in_position );
+    m_transferEnd = in_position + dataSize;
+
+    if ( in_write ) {
+        m_stats.writes++;
+        m_stats.bytesWritten += dataSize;
+        m_stats.writeLatency[ bucket ]++;
+    } else {
+        m_stats.reads++;
+        m_stats.bytesRead += dataSize;
+        m_stats.readLatency[ bucket ]++;
+    }
+}
+
+/*============================================================================*/
+static U64 clockTime()
+/*============================================================================*/
+{
+    // Nanoseconds of a monotonic clock.
+#ifdef OSFIO_LINUX
+    struct timespec now;
+
+    ::clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( U64( now.tv_sec ) * 1000000000 ) + U64( now.tv_nsec );
+#else
+    return U64( ::clock()) * ( 1000000000 / CLOCKS_PER_SEC );
+#endif
+}
+
+/*============================================================================*/
+static bool isStorageName( const STRING name )
+/*============================================================================*/
+{
+    return (( NULL != name ) &&
+            ( ::strncmp( name, STORAGE_PREFIX, ::strlen( STORAGE_PREFIX )) == 0 ));
+}
+
+/*============================================================================*/
+static sMOUNT* findMount( const STRING name )
+/*============================================================================*/
+{
+    sMOUNT* pMount = pMountListEntry;
+
+    while (( NULL != pMount ) && ( ::strcmp( pMount->pName, name ) != 0 )) {
+        pMount = pMount->pNext;
+    }
+
+    return pMount;
+}
+
+/*============================================================================*/
+static bool addMount( const STRING name, OSSTORAGE* pStorage, bool owned )
+/*============================================================================*/
+{
+    if ( NULL != findMount( name )) {
+        return false;
+    }
+
+    sMOUNT* pMount = (sMOUNT*)::malloc( sizeof( sMOUNT ));
+    STRING  pName  = (STRING)::malloc( ::strlen( name ) + 1 );
+
+    if (( NULL == pMount ) || ( NULL == pName )) {
+        ::free( pMount );
+        ::free( pName );
+        return false;
+    }
+
+    ::strcpy( pName, name );
+
+    pMount->pName    = pName;
+    pMount->pStorage = pStorage;
+    pMount->owned    = owned;
+    pMount->pNext    = pMountListEntry;
+    pMountListEntry  = pMount;
+
+    return true;
+}
+
+/*============================================================================*/
+static OSFIO::sCACHE* openCache( U32 in_cacheSize )
+/*============================================================================*/
+{
+    OSFIO::sCACHE* pCache = new OSFIO::sCACHE;
+
+    if ( NULL == pCache ) {
+        return NULL;
+    }
+
+    pCache->nrOfBlocks = in_cacheSize / CACHE_BLOCK_SIZE;
+    pCache->nrOfUsed   = 0;
+    pCache->freeHead   = NO_BLOCK;
+    pCache->lruHead    = NO_BLOCK;
+    pCache->lruTail    = NO_BLOCK;
+    pCache->hashMask   = 1;
+
+    while ( pCache->hashMask < ( 2 * pCache->nrOfBlocks )) {
+        pCache->hashMask <<= 1;
+    }
+
+    pCache->pMemory = (BYTE*)::malloc(( U64( pCache->nrOfBlocks ) * CACHE_BLOCK_SIZE ) +
+                                      CACHE_BLOCK_SIZE );
+    pCache->pBlock  = (sCACHE_BLOCK*)::malloc( pCache->nrOfBlocks * sizeof( sCACHE_BLOCK ));
+    pCache->pHash   = (U32*)::malloc( pCache->hashMask * sizeof( U32 ));
+    pCache->hashMask--;
+    pCache->stats.nrOfBlocks = pCache->nrOfBlocks;
+
+    if (( NULL == pCache->pMemory ) || ( NULL == pCache->pBlock ) || ( NULL == pCache->pHash )) {
+        closeCache( pCache );
+        return NULL;
+    }
+
+    // Blocks are aligned to the block size.
+    pCache->pData = pCache->pMemory + ( CACHE_BLOCK_SIZE -
+                    ( size_t( pCache->pMemory ) % CACHE_BLOCK_SIZE ));
+    ::memset( pCache->pHash, 0xFF, (( pCache->hashMask + 1 ) * sizeof( U32 )));
+
+    return pCache;
+}
+
+/*============================================================================*/
+static void closeCache( OSFIO::sCACHE* pCache )
+/*============================================================================*/
+{
+    ::free( pCache->pMemory );
+    ::free( pCache->pBlock );
+    ::free( pCache->pHash );
+
+    delete pCache;
+}
+
+/*============================================================================*/
+static void unlinkBlock( OSFIO::sCACHE* pCache, U32 block )
+/*============================================================================*/
+{
+    sCACHE_BLOCK& rBlock = pCache->pBlock[ block ];
+
+    if ( rBlock.prev == NO_BLOCK ) {
+        pCache->lruHead = rBlock.next;
+    } else {
+        pCache->pBlock[ rBlock.prev ].next = rBlock.next;
+    }
+
+    if ( rBlock.next == NO_BLOCK ) {
+        pCache->lruTail = rBlock.prev;
+    } else {
+        pCache->pBlock[ rBlock.next ].prev = rBlock.prev;
+    }
+}
+
+/*============================================================================*/
+static void linkBlock( OSFIO::sCACHE* pCache, U32 block )
+/*============================================================================*/
+{
+    sCACHE_BLOCK& rBlock = pCache->pBlock[ block ];
+
+    rBlock.prev = NO_BLOCK; // Most recently used.
+    rBlock.next = pCache->lruHead;
+
+    if ( pCache->lruHead == NO_BLOCK ) {
+        pCache->lruTail = block;
+    } else {
+        pCache->pBlock[ pCache->lruHead ].prev = block;
+    }
+
+    pCache->lruHead = block;
+}
+
+/*============================================================================*/
+static void removeBlock( OSFIO::sCACHE* pCache, U32 block )
+/*============================================================================*/
+{
+    U32* pLink = &pCache->pHash[ U32( pCache->pBlock[ block ].blockNr ) & pCache->hashMask ];
+
+    while ( *pLink != block ) {
+        pLink = &pCache->pBlock[ *pLink ].hashNext;
+    }
+
+    *pLink = pCache->pBlock[ block ].hashNext;
+
+    unlinkBlock( pCache, block );
+}
+
+/*============================================================================*/
+static U32 findBlock( OSFIO::sCACHE* pCache, U64 blockNr )
+/*============================================================================*/
+{
+    U32 block = pCache->pHash[ U32( blockNr ) & pCache->hashMask ];
+
+    while (( block != NO_BLOCK ) && ( pCache->pBlock[ block ].blockNr != blockNr )) {
+        block = pCache->pBlock[ block ].hashNext;
+    }
+
+    if (( block != NO_BLOCK ) && ( block != pCache->lruHead )) {
+        unlinkBlock( pCache, block );
+        linkBlock( pCache, block );
+    }
+
+    return block;
+}
+
+/*============================================================================*/
+static U32 allocateBlock( OSFIO::sCACHE* pCache )
+/*============================================================================*/
+{
+    U32 block = pCache->freeHead;
+
+    if ( block != NO_BLOCK ) {
+        pCache->freeHead = pCache->pBlock[ block ].hashNext;
+    } else if ( pCache->nrOfUsed < pCache->nrOfBlocks ) {
+        block = pCache->nrOfUsed++;
+    } else {
+        // Replace the least recently used block.
+        block = pCache->lruTail;
+        removeBlock( pCache, block );
+        pCache->stats.evictions++;
+    }
+
+    return block;
+}
+
+/*============================================================================*/
+static void insertBlock( OSFIO::sCACHE* pCache, U32 block, U64 blockNr )
+/*============================================================================*/
+{
+    U32& rHash = pCache->pHash[ U32( blockNr ) & pCache->hashMask ];
+
+    pCache->pBlock[ block ].blockNr  = blockNr;
+    pCache->pBlock[ block ].hashNext = rHash;
+    rHash = block;
+
+    linkBlock( pCache, block );
+}
+
+/*============================================================================*/
+static void releaseBlock( OSFIO::sCACHE* pCache, U32 block )
+/*============================================================================*/
+{
+    pCache->pBlock[ block ].hashNext = pCache->freeHead;
+    pCache->freeHead = block;
+}
+
+/*============================================================================*/
+static void invalidateBlocks( OSFIO::sCACHE* pCache, U64 position, U64 dataSize )
+/*============================================================================*/
+{
+    if ( dataSize == 0 ) {
+        return;
+    }
+
+    U64 firstBlockNr = position / CACHE_BLOCK_SIZE;
+    U64 lastBlockNr  = ( position + dataSize - 1 ) / CACHE_BLOCK_SIZE;
+
+    if (( lastBlockNr - firstBlockNr ) < pCache->nrOfBlocks ) {
+        for ( U64 blockNr = firstBlockNr; blockNr <= lastBlockNr; blockNr++ ) {
+            U32 block = pCache->pHash[ U32( blockNr ) & pCache->hashMask ];
+
+            while (( block != NO_BLOCK ) && ( pCache->pBlock[ block ].blockNr != blockNr )) {
+                block = pCache->pBlock[ block ].hashNext;
+            }
+
+            if ( block != NO_BLOCK ) {
+                removeBlock( pCache, block );
+                releaseBlock( pCache, block );
+            }
+        }
+    } else {
+        // Large range, all cached blocks are checked.
+        U32 block = pCache->lruHead;
+
+        while ( block != NO_BLOCK ) {
+            U32 next    = pCache->pBlock[ block ].next;
+            U64 blockNr = pCache->pBlock[ block ].blockNr;
+
+            if (( blockNr >= firstBlockNr ) && ( blockNr <= lastBlockNr )) {
+                removeBlock( pCache, block );
+                releaseBlock( pCache, block );
+            }
+
+            block = next;
+        }
+    }
+}
+
+#ifdef OSFIO_URING
+/*============================================================================*/
+static OSFIO::sRING* openRing( U32 in_entries )
+/*============================================================================*/
+{
+    OSFIO::sRING* pRing = (OSFIO::sRING*)::calloc( 1, sizeof( OSFIO::sRING ));
+
+    if ( NULL == pRing ) {
+        return NULL;
+    }
+
+    io_uring_params params;
+    ::memset( &params, 0, sizeof( params ));
+
+    pRing->fd = (int)::syscall( __NR_io_uring_setup, in_entries, &params );
+
+    if ( pRing->fd < 0 ) {
+        ::free( pRing );
+        return NULL;
+    }
+
+    pRing->entries = params.sq_entries;
+    pRing->sqSize  = params.sq_off.array + ( params.sq_entries * sizeof( unsigned ));
+    pRing->cqSize  = params.cq_off.cqes + ( params.cq_entries * sizeof( io_uring_cqe ));
+
+    bool singleMap = (( params.features & IORING_FEAT_SINGLE_MMAP ) != 0 );
+
+    if ( singleMap ) {
+        pRing->sqSize = pRing->cqSize = MAX( pRing->sqSize, pRing->cqSize );
+    }
+
+    pRing->pSq = ::mmap( NULL, pRing->sqSize, ( PROT_READ | PROT_WRITE ),
+                         ( MAP_SHARED | MAP_POPULATE ), pRing->fd, IORING_OFF_SQ_RING );
+    pRing->pCq = singleMap ? pRing->pSq :
+                 ::mmap( NULL, pRing->cqSize, ( PROT_READ | PROT_WRITE ),
+                         ( MAP_SHARED | MAP_POPULATE ), pRing->fd, IORING_OFF_CQ_RING );
+
+    pRing->sqesSize = params.sq_entries * sizeof( io_uring_sqe );
+    void* pSqes = ::mmap( NULL, pRing->sqesSize, ( PROT_READ | PROT_WRITE ),
+                          ( MAP_SHARED | MAP_POPULATE ), pRing->fd, IORING_OFF_SQES );
+
+    if (( pRing->pSq == MAP_FAILED ) || ( pRing->pCq == MAP_FAILED ) || ( pSqes == MAP_FAILED )) {
+        pRing->pSq   = ( pRing->pSq == MAP_FAILED ) ? NULL : pRing->pSq;
+        pRing->pCq   = ( pRing->pCq == MAP_FAILED ) ? NULL : pRing->pCq;
+        pRing->pSqes = ( pSqes == MAP_FAILED ) ? NULL : (io_uring_sqe*)pSqes;
+        closeRing( pRing );
+        return NULL;
+    }
+
+    BYTE* pSq = (BYTE*)pRing->pSq;
+    BYTE* pCq = (BYTE*)pRing->pCq;
+
+    pRing->pSqes    = (io_uring_sqe*)pSqes;
+    pRing->pSqTail  = (unsigned*)( pSq + params.sq_off.tail );
+    pRing->pSqMask  = (unsigned*)( pSq + params.sq_off.ring_mask );
+    pRing->pSqArray = (unsigned*)( pSq + params.sq_off.array );
+    pRing->pCqHead  = (unsigned*)( pCq + params.cq_off.head );
+    pRing->pCqTail  = (unsigned*)( pCq + params.cq_off.tail );
+    pRing->pCqMask  = (unsigned*)( pCq + params.cq_off.ring_mask );
+    pRing->pCqes    = (io_uring_cqe*)( pCq + params.cq_off.cqes );
+
+    return pRing;
+}
+
+/*============================================================================*/
+static void closeRing( OSFIO::sRING* pRing )
+/*============================================================================*/
+{
+    if ( NULL != pRing->pSqes ) {
+        ::munmap( pRing->pSqes, pRing->sqesSize );
+    }
+
+    if (( NULL != pRing->pCq ) && ( pRing->pCq != pRing->pSq )) {
+        ::munmap( pRing->pCq, pRing->cqSize );
+    }
+
+    if ( NULL != pRing->pSq ) {
+        ::munmap( pRing->pSq, pRing->sqSize );
+    }
+
+    ::close( pRing->fd );
+    ::free( pRing );
 }
+#endif
@@ -28,27 +28,169 @@
 // ---- symbol definitions ----
 #define READ_ONLY_ACCESS  true
 #define READ_WRITE_ACCESS false
-#define EOF_POSITION      U32(-1)
+#define EOF_POSITION      U64(-1)
+#define CACHE_BLOCK_SIZE  4096 // Aligned block size of the block cache.
+#define DIRECT_ALIGNMENT  4096 // Offset, size and memory alignment of direct I/O.
+#define STORAGE_PREFIX    "mem:" // Name prefix of storages, see OSFIO::mount().
+#define LATENCY_BUCKETS   24 // Latency histogram size, see sIO_STATS.
+
+#if defined( __linux__ )
+#define OSFIO_LINUX       // Native Linux backend: pread/pwrite, fstat, ftruncate.
+#endif
+
+/** Piece of a vectored write, see OSFIO::write(). */
+struct sIO_VECTOR {
+    const POINTER pData;     // The pointer to data.
+    U32           dataSize;  // The number of bytes.
+};
+
+/** Block cache statistics, see OSFIO::getCacheStats(). */
+struct sCACHE_STATS {
+    U64 hits;       // Block reads served by the cache.
+    U64 misses;     // Block reads from the file.
+    U64 evictions;  // Least recently used blocks replaced.
+    U32 nrOfBlocks; // Number of cache blocks.
+
+    sCACHE_STATS() // Constructor.
+        :
+        hits( 0 ),
+        misses( 0 ),
+        evictions( 0 ),
+        nrOfBlocks( 0 ) {
+    }
+};
+
+/**
+*  I/O statistics, see OSFIO::getStats(). Transfers are reads and writes of
+*  the file or storage, buffered and cached data is not transfered. Bucket
+*  0 of a latency histogram counts transfers of less than 1 microsecond,
+*  bucket n transfers of 2^(n-1) up to 2^n microseconds. The last bucket
+*  counts all slower transfers.
+*/
+struct sIO_STATS {
+    U64 reads;        // Read transfers.
+    U64 writes;       // Write transfers, a vectored write is one transfer.
+    U64 otherCalls;   // Other system calls: size, truncate, allocate, submit.
+    U64 bytesRead;    // Bytes transfered by reads.
+    U64 bytesWritten; // Bytes transfered by writes.
+    U64 seekDistance; // Bytes between the end of a transfer and the next one.
+    U64 readLatency[ LATENCY_BUCKETS ];
+    U64 writeLatency[ LATENCY_BUCKETS ];
+
+    sIO_STATS() // Constructor.
+        :
+        reads( 0 ),
+        writes( 0 ),
+        otherCalls( 0 ),
+        bytesRead( 0 ),
+        bytesWritten( 0 ),
+        seekDistance( 0 ) {
+        for ( U32 i = 0; i < LATENCY_BUCKETS; i++ ) {
+            readLatency[ i ]  = 0;
+            writeLatency[ i ] = 0;
+        }
+    }
+};
+
+/**
+*  Storage backend of OSFIO. Files are accessed by system calls, a storage
+*  mounted by OSFIO::mount() replaces the file of its name.
+*/
+class OSSTORAGE {
+public:
+
+virtual ~OSSTORAGE() {}
+
+// Positional read, returns number of bytes read or -1 on failure.
+virtual S64 read( U64 in_position, POINTER out_dataPtr, U32 in_dataSize ) = 0;
+// Positional write of all data, the storage grows if needed.
+virtual bool write( U64 in_position, const POINTER in_dataPtr, U32 in_dataSize ) = 0;
+// Size of the storage in bytes.
+virtual U64 size() = 0;
+// Truncates or extends the storage, extended space reads as zeros.
+virtual bool resize( U64 in_size ) = 0;
+// Pointer to stored data, valid until the next write or resize. NULL if
+// the range is not inside the storage or the storage is not addressable.
+virtual const BYTE* view( U64 in_position, U64 in_dataSize ) = 0;
+// Time of last modification, see OSFIO::timestamp().
+virtual U32 timestamp() = 0;
+};
+
+/**
+*  Storage in memory. Heap memory grows by writes and is released by the
+*  destructor. A memory region of the caller, e.g. an mmap() of a file or
+*  of shared memory, has a fixed capacity and is not released.
+*/
+class OSMEMORY : public OSSTORAGE {
+public:
+
+OSMEMORY();
+
+/**
+*  @param    in_pRegion    The memory region.
+*  @param    in_capacity   Size of the region in bytes.
+*  @param    in_size       Number of bytes of valid data at the start of the
+*                          region, e.g. a database in an existing mapping.
+*/
+OSMEMORY( BYTE* in_pRegion,
+          U64   in_capacity,
+          U64   in_size = 0 );
+
+~OSMEMORY();
+
+S64 read( U64 in_position, POINTER out_dataPtr, U32 in_dataSize );
+bool write( U64 in_position, const POINTER in_dataPtr, U32 in_dataSize );
+U64 size();
+bool resize( U64 in_size );
+const BYTE* view( U64 in_position, U64 in_dataSize );
+U32 timestamp();
+
+private:
+BYTE* m_pData;
+U64   m_size;
+U64   m_capacity;
+bool  m_region;    // Memory of the caller, fixed capacity.
+U32   m_timestamp;
+
+// Grows the capacity to at least in_size bytes.
+bool reserve( U64 in_size );
+};
 
 class OSFIO {
 public:
 
+/** Access pattern of a file range, see advise(). */
+enum eADVICE {
+    ADVICE_NORMAL,     // Default read-ahead.
+    ADVICE_SEQUENTIAL, // Read in ascending order, more read-ahead.
+    ADVICE_RANDOM,     // Point reads, no read-ahead.
+    ADVICE_WILLNEED,   // Read soon, read-ahead starts now.
+    ADVICE_DONTNEED    // Not read soon, cached pages may be released.
+};
+
 OSFIO();
 ~OSFIO();
 
 /**
-*  Opens an existing file.
+*  Opens an existing file or a mounted storage, see mount().
 *
 *  @param    in_fileName   File name of the file.
 *  @param    in_readOnly   Flag to indicate readonly access.
+*  @param    in_cacheSize  Memory budget in bytes of the block cache. Reads
+*                          are served by cached blocks of CACHE_BLOCK_SIZE
+*                          bytes, replaced least recently used. 0 disables
+*                          the cache.
 *  @return   true if successful.
 *  @post     FIO operations can be performed on the opened file.
 */
 bool open( const STRING in_fileName,
-           bool         in_readOnly = false );
+           bool         in_readOnly = false,
+           U32          in_cacheSize = 0 );
 
 /**
-*  Creates a new file (RW) if the file does not exist.
+*  Creates a new file (RW) if the file does not exist. A name beginning
+*  with STORAGE_PREFIX creates and mounts an OSMEMORY storage instead, it
+*  persists after close() until erase().
 *
 *  @param    in_fileName   File name of the file.
 *  @return   true if successful.
@@ -86,10 +228,25 @@ bool write( const POINTER in_dataPtr,
 *  @param    in_dataSize   The number of bytes transfered. Default 1 byte.
 *  @return   true if successful.
 */
-bool write( U32           in_position,
+bool write( U64           in_position,
             const POINTER in_dataPtr,
             U32           in_dataSize = 1 );
 
+/**
+*  Writes an array of data pieces to one contiguous range of the file, on
+*  Linux with one system call.
+*
+*  @pre      Valid handle by open() or create().
+*  @param    in_position   The byte offset from the beginning of the file.
+*                          If EOF_POSITION the data is appended.
+*  @param    in_pVector    The array of data pieces, written in order.
+*  @param    in_count      The number of data pieces.
+*  @return   true if successful.
+*/
+bool write( U64               in_position,
+            const sIO_VECTOR* in_pVector,
+            U32               in_count );
+
 /**
 *  Reads data from an opened file.
 *
@@ -110,7 +267,7 @@ bool read( POINTER out_dataPtr,
 *  @param    in_dataSize   The number of bytes transfered. Default 1 byte.
 *  @return   true if successful.
 */
-bool read( U32     in_position,
+bool read( U64     in_position,
            POINTER out_dataPtr,
            U32     in_dataSize = 1 );
 
@@ -126,17 +283,17 @@ bool eof();
 *  Gives the size of file.
 *
 *  @pre      Valid handle by open() or create().
-*  @return   (U32)INVALID_VALUE on failure.
+*  @return   (U64)INVALID_VALUE on failure.
 */
-U32 size();
+U64 size();
 
 /**
 *  Gives the file pointer position. Byte offset from start of file.
 *
 *  @pre      Valid handle by open() or create().
-*  @return   (U32)INVALID_VALUE on failure.
+*  @return   (U64)INVALID_VALUE on failure.
 */
-U32 position();
+U64 position();
 
 /**
 *  Truncates the file at given file pointer position.
@@ -145,7 +302,7 @@ U32 position();
 *  @param    in_position   The byte offset from the start of the file.
 *  @return   true if successful.
 */
-bool truncate( U32 in_position );
+bool truncate( U64 in_position );
 
 /**
 *  Returns time of last modification in seconds since midnight (00:00:00),
@@ -157,14 +314,239 @@ bool truncate( U32 in_position );
 U32 timestamp();
 
 /**
-*  Deletes an existing file even if it is read-only.
+*  Maps a file opened read only into memory. Reads within the mapping are
+*  served by memory copies instead of system calls. The mapping is released
+*  on close().
+*
+*  @pre      Valid handle by open() with in_readOnly.
+*  @return   true if successful. False if not supported or not read only, the
+*            file is accessed by system calls then.
+*/
+bool map();
+
+/**
+*  Gives a pointer into the mapped file, no data is copied.
+*
+*  @pre      Mapped file by map().
+*  @param    in_position   The byte offset from the beginning of the file.
+*  @param    in_dataSize   The number of bytes to be accessed.
+*  @return   NULL if the file is not mapped or the range is not inside the
+*            mapping.
+*/
+const BYTE* view( U64 in_position,
+                  U32 in_dataSize );
+
+/**
+*  Enables a write-back buffer. Adjacent writes are merged into the buffer
+*  and written as one block. The buffer is written when a write is not
+*  adjacent, when it is full, on flush(), on close() and before a read of
+*  buffered data.
+*
+*  @pre      Valid handle by open() (read/write) or create().
+*  @param    in_bufferSize Size of the buffer in bytes. 0 disables buffering.
+*  @return   true if successful.
+*/
+bool setWriteBuffer( U32 in_bufferSize );
+
+/**
+*  Writes buffered data to the file, see setWriteBuffer().
+*
+*  @return   true if successful.
+*/
+bool flush();
+
+/**
+*  Writes buffered data and commits the file data to the storage device
+*  (Linux fdatasync). Metadata not needed to read the data back, e.g. the
+*  modification time, is not committed.
+*
+*  @pre      Valid handle by open() or create().
+*  @return   true if successful.
+*/
+bool sync();
+
+/**
+*  Announces the access pattern of a file range (Linux posix_fadvise, and
+*  madvise of a mapped file). The operating system adjusts read-ahead and
+*  caching of the file, no data is changed.
+*
+*  @pre      Valid handle by open() or create().
+*  @param    in_advice     The access pattern.
+*  @param    in_position   The byte offset from the beginning of the file.
+*  @param    in_size       The number of bytes, 0 up to the end of the file.
+*  @return   true if successful, false if not supported by the platform.
+*/
+bool advise( eADVICE in_advice,
+             U64     in_position = 0,
+             U64     in_size = 0 );
+
+/**
+*  Preallocates disk space for a file range (Linux fallocate). Allocated
+*  space beyond the end of the file extends the file, it reads as zeros.
+*
+*  @pre      Valid handle by open() (read/write).
+*  @param    in_position   The byte offset from the beginning of the file.
+*  @param    in_size       The number of bytes to allocate.
+*  @return   true if successful, false if not supported by the platform or
+*            file system.
+*/
+bool allocate( U64 in_position,
+               U64 in_size );
+
+/**
+*  Enables direct I/O (Linux O_DIRECT), file data bypasses the page cache
+*  of the operating system. Unaligned reads and writes are transfered by
+*  an aligned buffer, unaligned writes are read-modify-write of the first
+*  and last block.
+*
+*  @pre      Valid handle by open() or create().
+*  @param    in_direct     true enables, false disables direct I/O.
+*  @return   true if successful, false if not supported by the platform or
+*            file system.
+*/
+bool setDirectIO( bool in_direct );
+
+/**
+*  Sets the number of queued requests submitted with one system call. On
+*  Linux the queue is executed asynchronously by io_uring, created on the
+*  first submit(). Without io_uring support queued requests are executed
+*  synchronously.
+*
+*  @param    in_queueDepth Number of requests per system call. 0 executes
+*                          queued requests synchronously.
+*  @return   true if successful.
+*/
+bool setQueueDepth( U32 in_queueDepth );
+
+/**
+*  Queues a read, executed by submit(). The file pointer is not used.
+*
+*  @pre      Valid handle by open() or create().
+*  @param    in_position   The byte offset from the beginning of the file.
+*  @param    out_dataPtr   The pointer to data, valid until submit().
+*  @param    in_dataSize   The number of bytes transfered.
+*  @return   true if successful.
+*/
+bool queueRead( U64     in_position,
+                POINTER out_dataPtr,
+                U32     in_dataSize );
+
+/**
+*  Queues a write, executed by submit(). The file pointer is not used and
+*  the write-back buffer is bypassed.
+*
+*  @pre      Valid handle by open() (read/write) or create().
+*  @param    in_position   The byte offset from the beginning of the file.
+*  @param    in_dataPtr    The pointer to data, valid until submit().
+*  @param    in_dataSize   The number of bytes transfered.
+*  @return   true if successful.
+*/
+bool queueWrite( U64           in_position,
+                 const POINTER in_dataPtr,
+                 U32           in_dataSize );
+
+/**
+*  Executes all queued requests and waits for their completion. The order
+*  of execution is not defined, queued requests must not overlap when one
+*  of them is a write. The queue is empty afterwards.
+*
+*  @return   true if all requests transfered all data.
+*/
+bool submit();
+
+/**
+*  Retrieves the block cache statistics, see open().
+*
+*  @param    out_rStats    The statistics since open().
+*  @return   true if the block cache is enabled.
+*/
+bool getCacheStats( sCACHE_STATS& out_rStats );
+
+/**
+*  Retrieves the I/O statistics since open() or resetStats(). Statistics
+*  are kept after close().
+*
+*  @param    out_rStats    The statistics.
+*/
+void getStats( sIO_STATS& out_rStats );
+
+/**
+*  Resets the I/O statistics, see getStats().
+*/
+void resetStats();
+
+/**
+*  Deletes an existing file even if it is read-only. A mounted storage is
+*  unmounted, a storage created by create() is released.
 *
 *  @param    in_fileName   File name of the file.
 *  @return   true if successful.
 */
 static bool erase( const STRING in_fileName );
 
+/**
+*  Mounts a storage, open() of its name accesses the storage instead of a
+*  file. Write buffer, block cache, io_uring and direct I/O are not used by
+*  a storage, map() gives a view of the storage memory.
+*
+*  @param    in_name       Name beginning with STORAGE_PREFIX.
+*  @param    in_pStorage   The storage, owned by the caller. It must stay
+*                          valid until it is unmounted by erase().
+*  @return   false if the name is not valid or already mounted.
+*/
+static bool mount( const STRING in_name,
+                   OSSTORAGE*   in_pStorage );
+
+// Forward declaration.
+struct sIO_REQUEST;   // Queued request, see queueRead().
+struct sRING;         // Asynchronous backend, see setQueueDepth().
+struct sCACHE;        // Block cache, see open().
+
 private:
-int m_handle;
+int   m_handle;
+bool  m_readOnly;
+BYTE* m_pMap;    // Read only mapping of the file, see map().
+U64   m_mapSize;
+U64   m_position; // File pointer, positional I/O does not depend on it.
+BYTE* m_pWriteBuffer; // Write-back buffer, see setWriteBuffer().
+U32   m_writeBufferSize;
+U32   m_writeLength;
+U64   m_writePosition;
+
+sIO_REQUEST* m_pRequests;
+U32          m_nrOfRequests;
+U32          m_allocatedRequests;
+U32          m_queueDepth;
+sRING*       m_pRing;
+sCACHE*      m_pCache;
+bool         m_direct;
+BYTE*        m_pDirectMemory; // Allocation of m_pDirectBuffer.
+BYTE*        m_pDirectBuffer; // Aligned buffer for direct I/O.
+OSSTORAGE*   m_pStorage;      // Mounted storage instead of a file.
+sIO_STATS    m_stats;
+U64          m_transferEnd;   // End of the last transfer, see seekDistance.
+
+// Buffered write, adjacent data is merged.
+bool bufferWrite( U64 in_position, const POINTER in_dataPtr, U32 in_dataSize );
+// Unbuffered positional read, returns number of bytes read or ERROR.
+S64 readAt( U64 in_position, POINTER out_dataPtr, U32 in_dataSize );
+// Unbuffered positional write of all data.
+bool writeAt( U64 in_position, const POINTER in_dataPtr, U32 in_dataSize );
+// Unbuffered positional write of all data pieces.
+bool writeAt( U64 in_position, const sIO_VECTOR* in_pVector, U32 in_count );
+// Adds a request to the queue.
+bool queue( U64 in_position, BYTE* in_pData, U32 in_dataSize, bool in_write );
+// Synchronous execution of a queued request.
+bool execute( const sIO_REQUEST& in_rRequest );
+// Asynchronous execution of all queued requests.
+bool submitRing();
+// Read served by the block cache.
+bool cacheRead( U64 in_position, BYTE* out_pData, U32 in_dataSize );
+// Direct I/O read, returns number of bytes read or ERROR.
+S64 directRead( U64 in_position, BYTE* out_pData, U32 in_dataSize );
+// Direct I/O write of all data pieces.
+bool directWrite( U64 in_position, const sIO_VECTOR* in_pVector, U32 in_count );
+// Adds a transfer of in_result bytes or ERROR to the statistics.
+void account( bool in_write, U64 in_position, S64 in_result, U64 in_startTime );
 };
 #endif  // OSFIO_HPP
@@ -24,7 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
-#include <sys\timeb.h>
+#include <sys/timeb.h>
 
 // ---- application includes ----
 #include <osfio.hpp>
@@ -33,12 +33,12 @@
 #define DATA_SIZE 1024
 
 // ---- data definitions ----
-STRING  file_name = "TEST.DB";
+char    file_name[] = "TEST.DB";
 OSFIO   handle;
 BYTE    test_data1[ DATA_SIZE ];
 BYTE    test_data2[ DATA_SIZE ];
-U32     file_size     = 0;
-U32     file_pointer  = 0;
+U64     file_size     = 0;
+U64     file_pointer  = 0;
 U32     passedCounter = 0;
 U32     failedCounter = 0;
 
@@ -137,26 +137,26 @@ bool test2( void )
 
     status_ok = status_ok && handle.open( file_name );
 
-    for ( int i = 0; i < sizeof( test_data1 ); i++ ) {
+    for ( U32 i = 0; i < sizeof( test_data1 ); i++ ) {
         test_data1[ i ] = (BYTE)i;
     }
 
     memset( test_data2, 0, DATA_SIZE );
 
     status_ok = status_ok && (( file_pointer = handle.position() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_pointer == 0);
 
     status_ok = status_ok && handle.write( test_data1, DATA_SIZE );
 
     status_ok = status_ok && (( file_size = handle.size() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == DATA_SIZE );
 
     status_ok = status_ok && (( file_pointer = handle.position() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == file_pointer );
 
@@ -186,19 +186,19 @@ bool  test3( void )
     bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
 
     status_ok = status_ok && (( file_pointer = handle.position() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_pointer == 0 );
 
     status_ok = status_ok && handle.write( EOF_POSITION, test_data1, DATA_SIZE );
 
     status_ok = status_ok && (( file_size = handle.size() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == ( 2 * DATA_SIZE ) );
 
     status_ok = status_ok && (( file_pointer = handle.position() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == file_pointer );
 
@@ -213,12 +213,12 @@ bool  test3( void )
     status_ok = status_ok && handle.truncate( DATA_SIZE );
 
     status_ok = status_ok && (( file_size = handle.size() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == DATA_SIZE );
 
     status_ok = status_ok && (( file_pointer = handle.position() ) !=
-                              (U32)INVALID_VALUE );
+                              (U64)INVALID_VALUE );
 
     status_ok = status_ok && ( file_size == file_pointer );
 
@@ -231,19 +231,535 @@ bool  test3( void )
     return status_ok;
 }
 
+/*============================================================================*/
+bool  test4( void )
+/*============================================================================*/
+{
+    printDescription( 4, "Buffered write file" );
+
+    const U32 chunkSize = 64;
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.setWriteBuffer( 4 * DATA_SIZE );
+
+    // Small adjacent writes are merged in the buffer.
+    status_ok = status_ok && handle.write( DATA_SIZE, test_data1, chunkSize );
+
+    for ( U32 i = chunkSize; status_ok && ( i < DATA_SIZE ); i += chunkSize ) {
+        status_ok = handle.write( &test_data1[ i ], chunkSize );
+    }
+
+    status_ok = status_ok && (( file_size = handle.size() ) !=
+                              (U64)INVALID_VALUE );
+
+    status_ok = status_ok && ( file_size == ( 2 * DATA_SIZE ) );
+
+    status_ok = status_ok && (( file_pointer = handle.position() ) !=
+                              (U64)INVALID_VALUE );
+
+    status_ok = status_ok && ( file_size == file_pointer );
+
+    // Reading buffered data writes the buffer first.
+    status_ok = status_ok && handle.read( DATA_SIZE, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && handle.write( EOF_POSITION, test_data1, chunkSize );
+
+    status_ok = status_ok && handle.flush();
+
+    status_ok = status_ok && handle.setWriteBuffer( 0 );
+
+    status_ok = status_ok && handle.close();
+
+    status_ok = status_ok && handle.open( file_name, READ_ONLY_ACCESS );
+
+    status_ok = status_ok && !handle.setWriteBuffer( DATA_SIZE );
+
+    status_ok = status_ok && ( handle.size() == ( 2 * DATA_SIZE + chunkSize ));
+
+    status_ok = status_ok && handle.read(( 2 * DATA_SIZE ), test_data2, chunkSize );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, chunkSize ) == 0 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test5( void )
+/*============================================================================*/
+{
+    printDescription( 5, "Vectored write file" );
+
+    U32 const pieceSize = DATA_SIZE / 4;
+    sIO_VECTOR vector[] = {
+        { &test_data1[ 0 ], pieceSize },
+        { &test_data1[ pieceSize ], pieceSize },
+        { &test_data1[ 2 * pieceSize ], 2 * pieceSize }
+    };
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.write( 0, vector, 3 );
+
+    status_ok = status_ok && ( handle.position() == DATA_SIZE );
+
+    status_ok = status_ok && handle.read( 0, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    // Buffered, appended.
+    status_ok = status_ok && handle.setWriteBuffer( 2 * DATA_SIZE );
+
+    status_ok = status_ok && (( file_size = handle.size() ) !=
+                              (U64)INVALID_VALUE );
+
+    status_ok = status_ok && handle.write( EOF_POSITION, vector, 3 );
+
+    status_ok = status_ok && ( handle.size() == ( file_size + DATA_SIZE ));
+
+    status_ok = status_ok && handle.close();
+
+    status_ok = status_ok && handle.open( file_name, READ_ONLY_ACCESS );
+
+    status_ok = status_ok && handle.read( file_size, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test6( void )
+/*============================================================================*/
+{
+    printDescription( 6, "Queued read and write file" );
+
+    U32 const pieceSize = DATA_SIZE / 8;
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    // Asynchronous and synchronous execution, more requests than the depth.
+    for ( U32 pass = 0; status_ok && ( pass < 2 ); pass++ ) {
+        status_ok = handle.setQueueDepth(( pass == 0 ) ? 4 : 0 );
+
+        for ( U32 i = 0; status_ok && ( i < DATA_SIZE ); i += pieceSize ) {
+            status_ok = handle.queueWrite( i, &test_data1[ i ], pieceSize );
+        }
+
+        status_ok = status_ok && handle.submit();
+
+        ::memset( test_data2, 0, DATA_SIZE );
+
+        for ( U32 i = 0; status_ok && ( i < DATA_SIZE ); i += pieceSize ) {
+            status_ok = handle.queueRead( i, &test_data2[ i ], pieceSize );
+        }
+
+        status_ok = status_ok && handle.submit();
+
+        status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+    }
+
+    // Reading beyond the end of file fails.
+    status_ok = status_ok && (( file_size = handle.size() ) !=
+                              (U64)INVALID_VALUE );
+
+    status_ok = status_ok && handle.queueRead( 0, test_data2, pieceSize );
+
+    status_ok = status_ok && handle.queueRead( file_size, test_data2, pieceSize );
+
+    status_ok = status_ok && !handle.submit();
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test7( void )
+/*============================================================================*/
+{
+    printDescription( 7, "Block cache read file" );
+
+    U32 const nrOfBlocks = 3;
+    sCACHE_STATS stats;
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    for ( U32 i = 0; status_ok && ( i < ( nrOfBlocks * CACHE_BLOCK_SIZE )); i += DATA_SIZE ) {
+        status_ok = handle.write( i, test_data1, DATA_SIZE );
+    }
+
+    status_ok = status_ok && !handle.getCacheStats( stats );
+
+    status_ok = status_ok && handle.close();
+
+    status_ok = status_ok && handle.open( file_name, READ_WRITE_ACCESS,
+                                          ( nrOfBlocks * CACHE_BLOCK_SIZE ));
+
+    // Miss, hit and a read over a block boundary.
+    status_ok = status_ok && handle.read( 0, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.read( DATA_SIZE, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && handle.read(( CACHE_BLOCK_SIZE - DATA_SIZE ), test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.read(( CACHE_BLOCK_SIZE - ( DATA_SIZE / 2 )), test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.getCacheStats( stats );
+
+    status_ok = status_ok && ( stats.nrOfBlocks == nrOfBlocks );
+
+    status_ok = status_ok && ( stats.misses == 2 ) && ( stats.hits == 3 );
+
+    // Written data is read back, not the cached block.
+    status_ok = status_ok && handle.write( 0, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.read( 0, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && handle.getCacheStats( stats );
+
+    status_ok = status_ok && ( stats.misses == 3 ) && ( stats.evictions == 0 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test8( void )
+/*============================================================================*/
+{
+    printDescription( 8, "Direct I/O read and write file" );
+
+    U32 const offset = DIRECT_ALIGNMENT - 100; // Unaligned, over a block boundary.
+    sIO_VECTOR vector[] = {
+        { &test_data1[ 0 ], 10 },
+        { &test_data1[ 10 ], DATA_SIZE - 10 }
+    };
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.truncate( 1 );
+
+    // Not supported by every file system, then the page cache is used.
+    bool direct = status_ok && handle.setDirectIO( true );
+
+    status_ok = status_ok && handle.write( offset, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && ( handle.size() == ( offset + DATA_SIZE ));
+
+    status_ok = status_ok && handle.read( offset, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    // Append, the aligned write does not change the logical file size.
+    status_ok = status_ok && handle.write( EOF_POSITION, vector, 2 );
+
+    status_ok = status_ok && ( handle.size() == ( offset + ( 2 * DATA_SIZE )));
+
+    status_ok = status_ok && handle.read(( offset + DATA_SIZE ), test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    // Data before the unaligned write is not modified.
+    status_ok = status_ok && handle.write( 1, test_data1, 1 );
+
+    status_ok = status_ok && handle.read( offset, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && ( !direct || handle.setDirectIO( false ));
+
+    status_ok = status_ok && handle.read(( offset + DATA_SIZE ), test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && ( handle.size() == ( offset + ( 2 * DATA_SIZE )));
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test9( void )
+/*============================================================================*/
+{
+    printDescription( 9, "Preallocate file" );
+
+    U32 const allocateSize = 16 * DATA_SIZE;
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && (( file_size = handle.size() ) !=
+                              (U64)INVALID_VALUE );
+
+    // Not supported by every file system.
+    if ( status_ok && handle.allocate( file_size, allocateSize )) {
+        status_ok = ( handle.size() == ( file_size + allocateSize ));
+
+        status_ok = status_ok && handle.read(( file_size + allocateSize - DATA_SIZE ),
+                                             test_data2, DATA_SIZE );
+
+        for ( U32 i = 0; status_ok && ( i < DATA_SIZE ); i++ ) {
+            status_ok = ( test_data2[ i ] == 0 );
+        }
+
+        // Allocation inside the file does not change the size.
+        status_ok = status_ok && handle.allocate( 0, DATA_SIZE );
+
+        status_ok = status_ok && ( handle.size() == ( file_size + allocateSize ));
+    }
+
+    handle.close(); // close anyway
+
+    status_ok = status_ok && handle.open( file_name, READ_ONLY_ACCESS );
+
+    status_ok = status_ok && !handle.allocate( 0, DATA_SIZE );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test10( void )
+/*============================================================================*/
+{
+    printDescription( 10, "Memory storage read and write" );
+
+    char         memory_name[] = STORAGE_PREFIX "TEST.DB";
+    char         region_name[] = STORAGE_PREFIX "REGION.DB";
+    BYTE         region[ 2 * DATA_SIZE ];
+    OSMEMORY     memory( region, sizeof( region ));
+    sIO_VECTOR   vector[] = {
+        { &test_data1[ 0 ], 10 },
+        { &test_data1[ 10 ], DATA_SIZE - 10 }
+    };
+
+    bool status_ok = !handle.open( memory_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.create( memory_name );
+
+    status_ok = status_ok && handle.write( test_data1, DATA_SIZE );
+
+    status_ok = status_ok && handle.write( EOF_POSITION, vector, 2 );
+
+    status_ok = status_ok && ( handle.size() == ( 2 * DATA_SIZE ));
+
+    status_ok = status_ok && !handle.setDirectIO( true );
+
+    handle.close(); // close anyway
+
+    // The storage persists until erase().
+    status_ok = status_ok && handle.open( memory_name, READ_ONLY_ACCESS );
+
+    status_ok = status_ok && handle.read( DATA_SIZE, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && !handle.write( 0, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.map();
+
+    status_ok = status_ok && ( handle.view( 0, DATA_SIZE ) != NULL ) &&
+                ( memcmp( test_data1, handle.view( 0, DATA_SIZE ), DATA_SIZE ) == 0 );
+
+    handle.close(); // close anyway
+
+    status_ok = status_ok && handle.erase( memory_name );
+
+    status_ok = status_ok && !handle.open( memory_name, READ_ONLY_ACCESS );
+
+    // A region has a fixed capacity.
+    status_ok = status_ok && OSFIO::mount( region_name, &memory );
+
+    status_ok = status_ok && !OSFIO::mount( region_name, &memory );
+
+    status_ok = status_ok && handle.open( region_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.write( DATA_SIZE, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && !handle.write( EOF_POSITION, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && handle.read( 0, test_data2, DATA_SIZE );
+
+    for ( U32 i = 0; status_ok && ( i < DATA_SIZE ); i++ ) {
+        status_ok = ( test_data2[ i ] == 0 );
+    }
+
+    status_ok = status_ok && ( memcmp( test_data1, &region[ DATA_SIZE ], DATA_SIZE ) == 0 );
+
+    status_ok = status_ok && handle.truncate( DATA_SIZE ) && ( handle.size() == DATA_SIZE );
+
+    handle.close(); // close anyway
+
+    status_ok = status_ok && handle.erase( region_name );
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test11( void )
+/*============================================================================*/
+{
+    printDescription( 11, "I/O statistics" );
+
+    sIO_STATS stats;
+    U64       latencyCount = 0;
+
+    bool status_ok = handle.open( file_name, READ_WRITE_ACCESS );
+
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.reads == 0 ) && ( stats.writes == 0 );
+
+    status_ok = status_ok && handle.write( 0, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && handle.read(( 2 * DATA_SIZE ), test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.read( 0, test_data2, DATA_SIZE );
+
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.writes == 1 ) && ( stats.reads == 2 );
+
+    status_ok = status_ok && ( stats.bytesWritten == DATA_SIZE ) &&
+                ( stats.bytesRead == ( 2 * DATA_SIZE ));
+
+    // Write ends at DATA_SIZE, reads start at 2 * DATA_SIZE and 0.
+    status_ok = status_ok && ( stats.seekDistance == ( 4 * DATA_SIZE ));
+
+    for ( U32 i = 0; i < LATENCY_BUCKETS; i++ ) {
+        latencyCount += stats.readLatency[ i ] + stats.writeLatency[ i ];
+    }
+
+    status_ok = status_ok && ( latencyCount == 3 );
+
+    // Buffered writes are transfered by flush().
+    status_ok = status_ok && handle.setWriteBuffer( 4 * DATA_SIZE );
+
+    status_ok = status_ok && handle.write( 0, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && handle.write( DATA_SIZE, test_data1, DATA_SIZE );
+
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.writes == 1 );
+
+    status_ok = status_ok && handle.flush();
+
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.writes == 2 ) &&
+                ( stats.bytesWritten == ( 3 * DATA_SIZE ));
+
+    handle.resetStats();
+
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.reads == 0 ) && ( stats.bytesWritten == 0 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test12( void )
+/*============================================================================*/
+{
+    printDescription( 12, "Synchronize file data" );
+
+    sIO_STATS stats;
+
+    bool status_ok = !handle.sync(); // Fails, not opened!
+
+    status_ok = status_ok && handle.open( file_name, READ_WRITE_ACCESS );
+
+    status_ok = status_ok && handle.setWriteBuffer( 4 * DATA_SIZE );
+
+    status_ok = status_ok && handle.write( 0, test_data1, DATA_SIZE );
+
+    status_ok = status_ok && handle.sync();
+
+    // Buffered data is written, one other system call.
+    handle.getStats( stats );
+
+    status_ok = status_ok && ( stats.writes == 1 ) && ( stats.otherCalls == 1 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
+/*============================================================================*/
+bool  test13( void )
+/*============================================================================*/
+{
+    printDescription( 13, "Access pattern hints" );
+
+    bool status_ok = !handle.advise( OSFIO::ADVICE_RANDOM ); // Fails, not opened!
+
+    status_ok = status_ok && handle.open( file_name, READ_ONLY_ACCESS );
+
+    status_ok = status_ok && handle.advise( OSFIO::ADVICE_SEQUENTIAL );
+
+    status_ok = status_ok && handle.advise( OSFIO::ADVICE_WILLNEED, DATA_SIZE, DATA_SIZE );
+
+    status_ok = status_ok && !handle.advise( OSFIO::eADVICE( OSFIO::ADVICE_DONTNEED + 1 ));
+
+    // The mapping is advised as well.
+    status_ok = status_ok && handle.map();
+
+    status_ok = status_ok && handle.advise( OSFIO::ADVICE_RANDOM, ( DATA_SIZE + 1 ), DATA_SIZE );
+
+    status_ok = status_ok && handle.read( DATA_SIZE, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && handle.advise( OSFIO::ADVICE_DONTNEED );
+
+    status_ok = status_ok && handle.read( 0, test_data2, DATA_SIZE );
+
+    status_ok = status_ok && ( memcmp( test_data1, test_data2, DATA_SIZE ) == 0 );
+
+    handle.close(); // close anyway
+
+    return status_ok;
+}
+
 int main() {
     time_t startTime;
     ::time( &startTime );
     ::printf( "OSFIO TEST started at %s\n", ::ctime( &startTime ) );
     ::printf( "OSFIO TEST started at %s\n", ctime( &startTime ));
-    ::printf( "OSDEF size of type bool = %d\n", sizeof( bool ));
-    ::printf( "OSDEF size of type U32 = %d\n", sizeof( U32 ));
-    ::printf( "OSDEF size of type STRING = %d\n", sizeof( STRING ));
-    ::printf( "OSDEF size of type POINTER = %d\n\n", sizeof( POINTER ));
+    ::printf( "OSDEF size of type bool = %d\n", int( sizeof( bool )));
+    ::printf( "OSDEF size of type U32 = %d\n", int( sizeof( U32 )));
+    ::printf( "OSDEF size of type STRING = %d\n", int( sizeof( STRING )));
+    ::printf( "OSDEF size of type POINTER = %d\n\n", int( sizeof( POINTER )));
 
     printResult( test1() );
     printResult( test2() );
     printResult( test3() );
+    printResult( test4() );
+    printResult( test5() );
+    printResult( test6() );
+    printResult( test7() );
+    printResult( test8() );
+    printResult( test9() );
+    printResult( test10() );
+    printResult( test11() );
+    printResult( test12() );
+    printResult( test13() );
     handle.erase( file_name );
 
     ::printf( "\nOSFIO TEST %d passed, %d failed, stopped at %s\n\n",
@@ -43,14 +43,34 @@
 // ---- system include files ----
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 // ---- include files ----
 #include <osfio.hpp>
 #include <osndxfio.hpp>
 
+#ifdef OSFIO_LINUX
+#include <pthread.h>
+#endif
+
 // ---- local symbol definitions ----
-#define NDXFIO_VERSION  0x01000000 // major.minor.patch - major, minor = 8 bits
+#define NDXFIO_VERSION  0x02000000 // major.minor.patch - major, minor = 8 bits
+#define NDXFIO_VERSION_1 0x01000000 // 32-bit offsets, read only.
+#define VERSION_MAJOR( v ) ( U32( v ) >> 24 )
 #define MAX_MALLOC      (1 << 30)  // maximum memory allocation 2**30
+#define WRITE_BUFFER    (1 << 18)  // write-back buffer of read/write databases
+#define QUEUE_DEPTH     128        // reads per system call, see getRecords()
+#define SCAN_GAP        16         // max. index step of a scan, see getRecord()
+#define SCAN_LENGTH     8          // records read by a scan before read-ahead
+#define INSERTION_SORT  16         // partition size sorted by insertion, see sortKeyIndex()
+#define PARALLEL_SORT   4096       // min. partition size of a sort task, see sortKeyIndices()
+#define PREFETCH_SLOTS  16         // layout slots 4 levels ahead, see lowerBoundLayout()
+
+#ifdef __GNUC__
+#define PREFETCH( p )   __builtin_prefetch( p )
+#else
+#define PREFETCH( p )
+#endif
 
 /** Index record status. Do not modify or erase regarding backward
     compatibility! */
@@ -63,12 +83,12 @@ enum eINDEX_STATUS {
 /** Index structure. The index structure is followed by the application key. */
 struct sINDEX {
     union {
-        S32 status;           // Status of the index record
-        S32 prevDeletedIndex; // The offset is not valid when record is deleted.
+        S64 status;           // Status of the index record
+        S64 prevDeletedIndex; // The offset is not valid when record is deleted.
     };                        // If >= zero this field points to the previous
                               // deleted record.
-    U32 offset;               // Byte offset of index record in the file
-    U32 dataOffset;           // Byte offset of data record in the file
+    U64 offset;               // Byte offset of index record in the file
+    U64 dataOffset;           // Byte offset of data record in the file
     U32 dataSize;             // Size of the object in the file, see offset.
     U32 recordRef;            // Verification reference for data records.
     /** KEY **/               // Start of application key
@@ -76,8 +96,8 @@ struct sINDEX {
     sINDEX()                  // Constructor.
         :
         status( eRESERVED ),
-        offset( U32( INVALID_VALUE )),
-        dataOffset( U32( INVALID_VALUE )),
+        offset( U64( INVALID_VALUE )),
+        dataOffset( U64( INVALID_VALUE )),
         dataSize( 0 ),
         recordRef( 0 ) {
     }
@@ -97,11 +117,19 @@ struct sDATA {
     S32 id;                  // Type of data record (eRECORD_ID).
     U32 recordRef;           // Verification reference for data records, should
     union {                  // match with record reference given by index record.
-        U32 size;            // Number of bytes occupied. Could be less than space
+        U64 size;            // Number of bytes occupied. Could be less than space
                              // to offset to next record.
-        U32 nextIndexOffset; // Reference to next index record if record id ==
+        U64 nextIndexOffset; // Reference to next index record if record id ==
     };                       // NEXT_INDEX.
-    U32 offset;              // Offset to next record.
+    U64 offset;              // Offset to next record.
+
+    sDATA()                  // Constructor.
+        :
+        id( eDATA ),
+        recordRef( 0 ),
+        size( 0 ),
+        offset( 0 ) {
+    }
 };
 
 /** Database header struct. */
@@ -109,19 +137,24 @@ struct sHEADER {
     U32 version;
     U32 recordReference;    // Verification reference, increased every
                             // record creation.
-    U32 nextFreeData;       // Offset to free data position.
+    U64 nextFreeData;       // Offset to free data position.
 
     U32 nrOfRecords;        // Number of all valid records (status == eOK).
     U32 nrOfIndexRecords;   // Total of all index records,
                             // status == eOK, eDELETED, eRESERVED.
-    S32 lastDeletedIndex;   // Offset to last deleted index record.
-    U32 nextFreeIndex;      // Offset to free index position.
+    S64 lastDeletedIndex;   // Offset to last deleted index record.
+    U64 nextFreeIndex;      // Offset to free index position.
     U16 reservedIndexRecords;
     U16 nrOfKeys;           // Number of defined search index keys.
     U16 totalKeySize;       // Sum of all key descriptor segment data
                             // search key sizes. Used for indexing.
     U16 keyDescriptorSize;  // Size sum of all key descriptor segments,
                             // key descriptor is stored adjacent to header.
+    U64 allocatedEnd;       // Preallocated end of the file, the file
+                            // may be larger than nextFreeData. Zero if
+                            // not preallocated, see setGrowth().
+    U64 reserved[ 3 ];      // Reserved for future use, zero.
+
     sHEADER()               // Constructor.
         :
         version( NDXFIO_VERSION ),
@@ -134,10 +167,69 @@ struct sHEADER {
         reservedIndexRecords( OSNDXFIO::DEFAULT_RESERVED_INDEX_RECORDS ),
         nrOfKeys( 0 ),
         totalKeySize( 0 ),
-        keyDescriptorSize( 0 ) {
+        keyDescriptorSize( 0 ),
+        allocatedEnd( 0 ) {
+        ::memset( reserved, 0, sizeof( reserved ));
+    }
+};
+
+/** Version 1 (32-bit offsets) file structures. Only used to read and upgrade
+    databases created before version 2. Do not modify! */
+struct sINDEX_V1 {
+    S32 status;
+    U32 offset;
+    U32 dataOffset;
+    U32 dataSize;
+    U32 recordRef;
+};
+
+struct sDATA_V1 {
+    S32 id;
+    U32 recordRef;
+    U32 size;
+    U32 offset;
+};
+
+struct sHEADER_V1 {
+    U32 version;
+    U32 recordReference;
+    U32 nextFreeData;
+    U32 nrOfRecords;
+    U32 nrOfIndexRecords;
+    S32 lastDeletedIndex;
+    U32 nextFreeIndex;
+    U16 reservedIndexRecords;
+    U16 nrOfKeys;
+    U16 totalKeySize;
+    U16 keyDescriptorSize;
+};
+
+/** Header of the sorted key indices file, see saveSortOrder(). The key
+    indices follow, nrOfIndexRecords entries per key. */
+struct sSORT_ORDER {
+    U32 version;          // NDXFIO_VERSION of the file.
+    U32 recordReference;  // Stamp of the database, see sHEADER.
+    U32 nrOfRecords;
+    U32 nrOfIndexRecords;
+    U16 nrOfKeys;
+    U16 reserved[ 3 ];    // Reserved for future use, zero.
+    U64 checksum;         // Of index records and key indices, see indexChecksum().
+
+    sSORT_ORDER() // Constructor.
+        :
+        version( NDXFIO_VERSION ),
+        recordReference( 0 ),
+        nrOfRecords( 0 ),
+        nrOfIndexRecords( 0 ),
+        nrOfKeys( 0 ),
+        checksum( 0 ) {
+        ::memset( reserved, 0, sizeof( reserved ));
     }
 };
 
+/** Key comparison like memcmp(), selected by the key size, see selectKeyCompare(). */
+typedef int KEY_COMPARE_FUNC( const BYTE* pKeyA, const BYTE* pKeyB, U32 in_size );
+
 /** Key index struct. */
 struct sKEY_INDEX {
     U32* apRecord;
@@ -149,6 +241,12 @@ struct sKEY_INDEX {
     U16  keyOffset;
     U16  keySize;
     bool bSorted;
+    OSNDXFIO::sKEY_STATS stats;
+    BYTE* apSortedKey;     // Keys in apRecord order, see sOPTIONS::keyArrays.
+    U32  sortedKeyCount;   // Keys allocated for apSortedKey.
+    KEY_COMPARE_FUNC* pfCompare; // Set by open().
+    BYTE* apLayoutKey;     // Keys in Eytzinger order, see sOPTIONS::searchLayout.
+    U32*  apLayoutPosition; // Position in apRecord of a layout slot.
 
     sKEY_INDEX() // Constructor.
         :
@@ -159,7 +257,13 @@ struct sKEY_INDEX {
         selectionEnd( U32( INVALID_VALUE )),
         keyOffset( U16( INVALID_VALUE )),
         keySize( 0 ),
-        bSorted( false ) {
+        bSorted( false ),
+        stats(),
+        apSortedKey( NULL ),
+        sortedKeyCount( 0 ),
+        pfCompare( NULL ),
+        apLayoutKey( NULL ),
+        apLayoutPosition( NULL ) {
     }
 };
 
@@ -178,6 +282,17 @@ struct OSNDXFIO::sHANDLE : sHEADER { // Inherit sHEADER
     U32 allocatedIndexKeys; // Required for allocating memory for
                             // apKey and apKeyIndex[ keys ].apRecord.
     U16 totalIndexSize;
+    U16 fileDataSize;       // Size of sDATA in the file, depends on version.
+    U16 fileIndexSize;      // Size of sINDEX + totalKeySize in the file.
+    U32 growthSize;         // Preallocation step, see setGrowth().
+    OSNDXFIO::sOPTIONS options;
+    U32 pendingChanges;     // Changes since the last synchronization.
+    time_t lastSync;        // Time of the last synchronization.
+    OSFIO::eADVICE advice;  // Announced access pattern of the file.
+    U32 lastIndex;          // Index of the last record read.
+    U32 scanLength;         // Records read in ascending index order.
+    bool sortOrderChanged;  // Key indices differ from the side file, see
+                            // saveSortOrder().
 
     sHANDLE() // Constructor.
         :
@@ -191,10 +306,55 @@ struct OSNDXFIO::sHANDLE : sHEADER { // Inherit sHEADER
         apKey( NULL ),
         apKeyDescriptor( NULL ),
         allocatedIndexKeys( 0 ),
-        totalIndexSize( 0 ) {
+        totalIndexSize( 0 ),
+        fileDataSize( sizeof( sDATA )),
+        fileIndexSize( 0 ),
+        growthSize( 0 ),
+        options(),
+        pendingChanges( 0 ),
+        lastSync( 0 ),
+        advice( OSFIO::ADVICE_NORMAL ),
+        lastIndex( U32( INVALID_VALUE )),
+        scanLength( 0 ),
+        sortOrderChanged( false ) {
     }
 };
 
+/** Key comparison of sortKeyIndex(). */
+struct sSORT_CONTEXT {
+    const BYTE*       pKey;           // Key of index record 0.
+    U32               totalIndexSize; // Distance between keys.
+    U32               keySize;
+    KEY_COMPARE_FUNC* pfCompare;      // Of the key index.
+};
+
+/** Abbreviated key sorted by sortKeyIndex(). The first key bytes as a big
+    endian number are ordered like the converted keys, most comparisons
+    need no access to the key. */
+struct sKEY_ENTRY {
+    U64 prefix;                 // First bytes of the key, zero padded.
+    U32 record;
+};
+
+/** Partition of a key index, sorted by a worker of sortKeyIndices(). */
+struct sSORT_TASK {
+    sSORT_CONTEXT context;
+    sKEY_ENTRY*   pFirst;
+    sKEY_ENTRY*   pLast;
+    U32           depthLimit;
+};
+
+#ifdef OSFIO_LINUX
+/** Tasks shared by the workers of sortKeyIndices(). */
+struct sSORT_POOL {
+    pthread_mutex_t mutex;
+    pthread_cond_t  condition;   // Signals new tasks or the last task done.
+    sSORT_TASK*     pTask;       // Stack of pending tasks.
+    U32             nrOfTasks;
+    U32             nrOfBusy;    // Workers sorting a task.
+};
+#endif
+
 // ---- local functions prototypes ----
 static bool isDatabaseNameValid( const STRING in_databaseName );
 static bool isKeyDescriptorValid(
@@ -206,14 +366,142 @@ static bool initKeyIndexArray(
     OSNDXFIO::sHANDLE* pHandle,
     U16 key );
 static bool initKeyArray( OSNDXFIO::sHANDLE* pHandle );
+static void growFile(
+    OSNDXFIO::sHANDLE* pHandle,
+    sHEADER& header,
+    U64 requiredEnd );
+static void adviseAccess(
+    OSNDXFIO::sHANDLE* pHandle,
+    OSFIO::eADVICE advice );
+static bool commitChange( OSNDXFIO::sHANDLE* pHandle );
+static bool syncChanges( OSNDXFIO::sHANDLE* pHandle );
+static bool readDataRecord(
+    OSNDXFIO::sHANDLE* pHandle,
+    U64 in_position,
+    sDATA& out_rData );
+static bool readIndexRecords(
+    OSNDXFIO::sHANDLE* pHandle,
+    U64 in_position,
+    U32 in_count,
+    BYTE* out_pIndex );
 static bool createReservedIndexRecords(
     OSFIO& handle,
-    U32 filePointer,
+    U64 filePointer,
     U16 reservedIndexRecords,
     U16 totalKeySize );
-static void shellSort(
+static U64 indexChecksum( const OSNDXFIO::sHANDLE* pHandle );
+static char* sortOrderName( const OSNDXFIO::sHANDLE* pHandle );
+static bool loadSortOrder( OSNDXFIO::sHANDLE* pHandle );
+static bool isKeyIndexSorted(
+    const OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId );
+static inline bool isLess(
+    const sSORT_CONTEXT& context,
+    U32 recordA,
+    U32 recordB );
+static bool saveSortOrder( OSNDXFIO::sHANDLE* pHandle );
+static KEY_COMPARE_FUNC* selectKeyCompare( U32 in_keySize );
+template <typename WORD, U32 NR_OF_WORDS>
+static int compareKey(
+    const BYTE* pKeyA,
+    const BYTE* pKeyB,
+    U32 in_size );
+static int compareBytes(
+    const BYTE* pKeyA,
+    const BYTE* pKeyB,
+    U32 in_size );
+static inline void loadWord( const BYTE* pKey, U16& out_rWord );
+static inline void loadWord( const BYTE* pKey, U32& out_rWord );
+static inline void loadWord( const BYTE* pKey, U64& out_rWord );
+static inline const BYTE* sortedKey(
+    const OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_position );
+static void buildSortedKeys(
+    OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_count );
+static bool reserveSortedKeys(
+    OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_count );
+static void buildSearchLayout(
+    OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId );
+static U32 fillSearchLayout(
+    const OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_position,
+    U32 in_slot );
+static U32 lowerBoundLayout(
+    const OSNDXFIO::sHANDLE* pHandle,
+    const OSNDXFIO::sKEY& in_rKey,
+    KEY_COMPARE_FUNC* pfCompare );
+static U32 gallopMatches(
+    const OSNDXFIO::sHANDLE* pHandle,
+    const OSNDXFIO::sKEY& in_rKey,
+    KEY_COMPARE_FUNC* pfCompare,
+    U32 in_match,
+    U32 in_limit );
+static U32 searchKeyIndex(
+    const OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_record,
+    U32 in_count );
+static void insertKeyIndex(
+    OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_record,
+    U32 in_count );
+static bool removeKeyIndex(
+    OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    U32 in_record,
+    U32 in_count );
+static void sortKeyIndices(
+    OSNDXFIO::sHANDLE* const pHandle,
+    U16 const in_firstKeyId,
+    U16 const in_nrOfKeys );
+static void sortKeyIndex(
     OSNDXFIO::sHANDLE* const pHandle,
     U16 const in_keyId );
+static void initSortTask(
+    OSNDXFIO::sHANDLE* const pHandle,
+    U16 const in_keyId,
+    sKEY_ENTRY* pEntry,
+    sSORT_TASK& out_rTask );
+static void initSortContext(
+    const OSNDXFIO::sHANDLE* pHandle,
+    U16 in_keyId,
+    sSORT_CONTEXT& out_rContext );
+static U32 sortDepthLimit( U32 in_count );
+template <typename ELEMENT>
+static ELEMENT* partition(
+    const sSORT_CONTEXT& context,
+    ELEMENT* pFirst,
+    ELEMENT* pLast );
+template <typename ELEMENT>
+static void sortRange(
+    const sSORT_CONTEXT& context,
+    ELEMENT* pFirst,
+    ELEMENT* pLast,
+    U32 depthLimit );
+template <typename ELEMENT>
+static void heapSort(
+    const sSORT_CONTEXT& context,
+    ELEMENT* pBase,
+    U32 count );
+template <typename ELEMENT>
+static void siftDown(
+    const sSORT_CONTEXT& context,
+    ELEMENT* pBase,
+    U32 root,
+    U32 count );
+template <typename ELEMENT>
+static void insertionSort(
+    const sSORT_CONTEXT& context,
+    ELEMENT* pFirst,
+    ELEMENT* pLast );
 static bool generateSearchKey(
     const OSNDXFIO::sHANDLE* pHandle,
     const OSNDXFIO::sRECORD& in_rRecord,
@@ -242,9 +530,10 @@ OSNDXFIO::~OSNDXFIO() {
 }
 
 /*============================================================================*/
-bool OSNDXFIO::open( const STRING in_databaseName,
-                     bool         in_readOnly,
-                     U32          in_allocatedIndexKeys )
+bool OSNDXFIO::open( const STRING    in_databaseName,
+                     bool            in_readOnly,
+                     U32             in_allocatedIndexKeys,
+                     const sOPTIONS& in_options )
 /*============================================================================*/
 {
     m_error = INVALID_PARAMETERS;
@@ -264,18 +553,79 @@ bool OSNDXFIO::open( const STRING in_databaseName,
 
     // Check database existence.
     if ( statusOk ) {
-        statusOk = m_handle->fileHandle.open( in_databaseName, in_readOnly );
+        statusOk = m_handle->fileHandle.open( in_databaseName, in_readOnly,
+                                              in_options.cacheSize );
+    }
+
+    if ( statusOk && in_readOnly ) {
+        // Optional, without mapping the file is read by system calls.
+        (void)m_handle->fileHandle.map();
+    } else if ( statusOk ) {
+        // Optional, merges the small writes of a record operation.
+        (void)m_handle->fileHandle.setWriteBuffer( WRITE_BUFFER );
+    }
+
+    if ( statusOk && in_options.directIO ) {
+        // Optional, without support the page cache is used.
+        (void)m_handle->fileHandle.setDirectIO( true );
+    }
+
+    if ( statusOk ) {
+        m_handle->options  = in_options;
+        m_handle->lastSync = ::time( NULL );
+    }
+
+    if ( statusOk ) {
+        // Optional, without a queue getRecords() reads synchronously.
+        (void)m_handle->fileHandle.setQueueDepth( QUEUE_DEPTH );
     }
 
     sDATA data;
+    U32   version     = 0;
+    U64   filePointer = 0;
     if ( statusOk ) {
-        // Read and verify header.
+        // Read and verify header. A version 1 header follows a smaller sDATA.
         m_error  = DATABASE_IO_ERROR;
-        statusOk = statusOk && m_handle->fileHandle.read( &data, sizeof( data ));
+        statusOk = m_handle->fileHandle.read( sizeof( sDATA_V1 ), &version, sizeof( version ));
+
+        if ( statusOk && ( VERSION_MAJOR( version ) == VERSION_MAJOR( NDXFIO_VERSION_1 ))) {
+            sHEADER_V1 header;
+            m_handle->fileDataSize = sizeof( sDATA_V1 );
+            filePointer = sizeof( sDATA_V1 ) + sizeof( header );
+            // Read header and widen it.
+            statusOk = m_handle->fileHandle.read( sizeof( sDATA_V1 ), &header, sizeof( header ));
+
+            m_handle->version              = header.version;
+            m_handle->recordReference      = header.recordReference;
+            m_handle->nextFreeData         = header.nextFreeData;
+            m_handle->nrOfRecords          = header.nrOfRecords;
+            m_handle->nrOfIndexRecords     = header.nrOfIndexRecords;
+            m_handle->lastDeletedIndex     = header.lastDeletedIndex;
+            m_handle->nextFreeIndex        = header.nextFreeIndex;
+            m_handle->reservedIndexRecords = header.reservedIndexRecords;
+            m_handle->nrOfKeys             = header.nrOfKeys;
+            m_handle->totalKeySize         = header.totalKeySize;
+            m_handle->keyDescriptorSize    = header.keyDescriptorSize;
+        } else {
+            filePointer = sizeof( sDATA ) + sizeof( sHEADER );
+            // Read header.
+            statusOk = statusOk && m_handle->fileHandle.read( sizeof( sDATA ), m_handle, sizeof( sHEADER ));
+        }
         // Check record id is correct.
+        statusOk = statusOk && readDataRecord( m_handle, 0, data );
         statusOk = statusOk && ( data.id == eHEADER );
-        // Read header.
-        statusOk = statusOk && m_handle->fileHandle.read( m_handle, sizeof( sHEADER ));
+    }
+
+    if ( statusOk ) {
+        m_error  = INVALID_DATABASE;
+        statusOk = (( VERSION_MAJOR( m_handle->version ) == VERSION_MAJOR( NDXFIO_VERSION )) ||
+                    ( VERSION_MAJOR( m_handle->version ) == VERSION_MAJOR( NDXFIO_VERSION_1 )));
+    }
+
+    if ( statusOk && ( VERSION_MAJOR( m_handle->version ) != VERSION_MAJOR( NDXFIO_VERSION ))) {
+        // Older versions are read only, see upgrade().
+        m_error  = UPGRADE_REQUIRED;
+        statusOk = in_readOnly;
     }
 
     if ( statusOk ) {
@@ -307,15 +657,17 @@ bool OSNDXFIO::open( const STRING in_databaseName,
         U16 keyOffset = sizeof( sINDEX );
 
         // Initialize memory.
-        ::memset( m_handle->apKeyIndex, 0, ( m_handle->nrOfKeys * sizeof( sKEY_INDEX )));
+        ::memset( (void*)m_handle->apKeyIndex, 0, ( m_handle->nrOfKeys * sizeof( sKEY_INDEX )));
         ::memset( m_handle->apKeyDescriptor, 0, ( m_handle->nrOfKeys * sizeof( sKEY_DESC )));
 
         // Read all key segments and key index records.
         for ( U16 i = 0; statusOk && ( i < m_handle->nrOfKeys ); i++ ) {
             // Read number of segments.
             statusOk = statusOk && m_handle->fileHandle.read(
+                           filePointer,
                            &( m_handle->apKeyDescriptor[ i ].nrOfSegments ),
                            sizeof( m_handle->apKeyDescriptor[ 0 ].nrOfSegments ));
+            filePointer += sizeof( m_handle->apKeyDescriptor[ 0 ].nrOfSegments );
 
             if ( statusOk ) {
                 totalSegmentSize = U16( m_handle->apKeyDescriptor[ i ].nrOfSegments *
@@ -331,7 +683,8 @@ bool OSNDXFIO::open( const STRING in_databaseName,
 
             // Read all segments per key.
             statusOk = statusOk && m_handle->fileHandle.read(
-                           m_handle->apKeyDescriptor[ i ].apSegment, totalSegmentSize );
+                           filePointer, m_handle->apKeyDescriptor[ i ].apSegment, totalSegmentSize );
+            filePointer += totalSegmentSize;
 
             if ( statusOk ) {
                 U16 keySize = 0;
@@ -342,6 +695,7 @@ bool OSNDXFIO::open( const STRING in_databaseName,
 
                 m_handle->apKeyIndex[ i ].keyOffset = keyOffset;
                 m_handle->apKeyIndex[ i ].keySize = keySize;
+                m_handle->apKeyIndex[ i ].pfCompare = selectKeyCompare( keySize );
 
                 keyOffset += keySize;
 
@@ -363,32 +717,56 @@ bool OSNDXFIO::open( const STRING in_databaseName,
 
     if ( statusOk ) {
         m_handle->totalIndexSize = (U16)( sizeof( sINDEX ) + m_handle->totalKeySize );
+        m_handle->fileIndexSize  = (U16)((( m_handle->fileDataSize == sizeof( sDATA )) ?
+                                          sizeof( sINDEX ) : sizeof( sINDEX_V1 )) +
+                                         m_handle->totalKeySize );
 
         m_error  = MEMORY_ALLOCATION_ERROR;
         statusOk = initKeyArray( m_handle );
 
-        statusOk = statusOk && m_handle->fileHandle.read( &data, sizeof( data ));
+        statusOk = statusOk && readDataRecord( m_handle, filePointer, data );
         // Check INDEX has been read.
         statusOk = statusOk && ( data.id == eINDEX );
-        // Read all index and application key records.
+        filePointer += m_handle->fileDataSize;
+        // Read all index and application key records, one read per block
+        // of reserved index records.
         BYTE* pByte = (BYTE*)m_handle->apKey;
-        U16   reservedIndexCounter = 0;
-        for ( U32 k = 0; statusOk && ( k < m_handle->nrOfIndexRecords ); k++ ) {
-            if ( reservedIndexCounter == m_handle->reservedIndexRecords ) {
+        U32   k     = 0;
+        statusOk = statusOk && ( m_handle->reservedIndexRecords > 0 );
+
+        while ( statusOk && ( k < m_handle->nrOfIndexRecords )) {
+            U32 count = MIN(( m_handle->nrOfIndexRecords - k ),
+                            U32( m_handle->reservedIndexRecords ));
+
+            // Deleted records are read as well!
+            statusOk = readIndexRecords( m_handle, filePointer, count, pByte );
+
+            filePointer += U64( count ) * m_handle->fileIndexSize;
+            pByte += count * m_handle->totalIndexSize;
+            k += count;
+
+            if ( statusOk && ( k < m_handle->nrOfIndexRecords )) {
                 // Check record ids and read next index offset.
-                statusOk = statusOk && m_handle->fileHandle.read( &data, sizeof( data ));
+                statusOk = readDataRecord( m_handle, filePointer, data );
                 statusOk = statusOk && ( data.id == eNEXT_INDEX );
-                statusOk = statusOk && m_handle->fileHandle.read( data.nextIndexOffset, &data, sizeof( data ));
+                filePointer = data.nextIndexOffset;
+                statusOk = statusOk && readDataRecord( m_handle, filePointer, data );
                 statusOk = statusOk && ( data.id == eINDEX );
-
-                reservedIndexCounter = 0;
+                filePointer += m_handle->fileDataSize;
             }
+        }
+    }
 
-            // Deleted records are read as well!
-            statusOk = statusOk && m_handle->fileHandle.read( pByte, m_handle->totalIndexSize );
+    // The key indices saved by close() are loaded if current.
+    if ( statusOk && !loadSortOrder( m_handle )) {
+        sortKeyIndices( m_handle, 0, m_handle->nrOfKeys );
+        m_handle->sortOrderChanged = true;
+    }
 
-            pByte += m_handle->totalIndexSize;
-            reservedIndexCounter++;
+    // Key indices of a read-only database never change.
+    if ( statusOk && m_handle->readOnly && m_handle->options.searchLayout ) {
+        for ( U16 k = 0; k < m_handle->nrOfKeys; k++ ) {
+            buildSearchLayout( m_handle, k );
         }
     }
 
@@ -411,9 +789,8 @@ bool OSNDXFIO::open( const STRING in_databaseName,
         m_handle->pNext = NULL;
         m_error = NO_ERROR;
 
-        for ( U16 keyId = 0; keyId < m_handle->nrOfKeys; keyId++  ) {
-            shellSort( m_handle, keyId );
-        }
+        // Records are read by key, scans are detected by getRecord().
+        adviseAccess( m_handle, OSFIO::ADVICE_RANDOM );
     } else {
         close();
     }
@@ -425,7 +802,8 @@ bool OSNDXFIO::open( const STRING in_databaseName,
 bool OSNDXFIO::create( const STRING     in_databaseName,
                        U16              in_nrOfKeys,
                        const sKEY_DESC  in_keyDescriptor[],
-                       U16              in_reservedIndexRecords )
+                       U16              in_reservedIndexRecords,
+                       const sOPTIONS&  in_options )
 /*============================================================================*/
 {
     // Check function parameters.
@@ -475,6 +853,8 @@ bool OSNDXFIO::create( const STRING     in_databaseName,
         statusOk = fileHandle.close();
 
         statusOk = statusOk && fileHandle.open( in_databaseName );
+        // Optional, reserved index records are written as large blocks.
+        (void)fileHandle.setWriteBuffer( WRITE_BUFFER );
 
         record.id = eHEADER;
         record.size  = sizeof( header ) + keyDescriptorSize;
@@ -484,6 +864,7 @@ bool OSNDXFIO::create( const STRING     in_databaseName,
         header.nrOfIndexRecords = header.reservedIndexRecords;
         header.nextFreeIndex = sizeof( record /* header id */ ) + record.size +
                                sizeof( record /* index id */ );
+        record.offset = sizeof( record /* header id */ ) + record.size;
         header.nextFreeData = header.nextFreeIndex + ( header.reservedIndexRecords *
                               ( sizeof( sINDEX ) + totalKeySize )) +
                               sizeof( record ); /* next index id */
@@ -510,12 +891,17 @@ bool OSNDXFIO::create( const STRING     in_databaseName,
                          record.size ),
                        header.reservedIndexRecords,
                        header.totalKeySize );
+
+        if ( in_options.durability != DURABILITY_NONE ) {
+            statusOk = statusOk && fileHandle.sync();
+        }
     }
 
-    fileHandle.close();
+    statusOk = fileHandle.close() && statusOk; // Writes buffered data.
 
     if ( statusOk ) {
-        statusOk = open( in_databaseName );
+        statusOk = open( in_databaseName, READ_WRITE_ACCESS,
+                         DEFAULT_ALLOCATED_INDEX_KEYS, in_options );
     }
 
     return statusOk;
@@ -525,12 +911,30 @@ bool OSNDXFIO::create( const STRING     in_databaseName,
 bool OSNDXFIO::close()
 /*============================================================================*/
 {
+    bool synced = true;
+
     if ( NULL != m_handle ) {
+        if (( m_handle->pendingChanges > 0 ) &&
+            ( m_handle->options.durability != DURABILITY_NONE )) {
+            synced = syncChanges( m_handle );
+        }
+
+        if ( m_handle->sortOrderChanged && m_handle->options.saveSortOrder ) {
+            // Optional, without the side file open() sorts the key indices.
+            (void)saveSortOrder( m_handle );
+        }
+
         if ( !m_handle->fileHandle.close() ) {
             m_error = NO_DATABASE;
+        } else if ( !synced ) {
+            m_error = DATABASE_IO_ERROR;
         }
 
         // Update the database administration.
+        if ( pDatabaseListEntry == m_handle ) {
+            pDatabaseListEntry = m_handle->pNext;
+        }
+
         if ( NULL != m_handle->pPrevious ) {
             (m_handle->pPrevious)->pNext = m_handle->pNext;
         }
@@ -543,8 +947,17 @@ bool OSNDXFIO::close()
         ::free( m_handle->apKey );
 
         for ( int i = 0; i < m_handle->nrOfKeys; i++ ) {
-            ::free( m_handle->apKeyDescriptor[ i ].apSegment );
-            ::free( m_handle->apKeyIndex[ i ].apRecord );
+            // Key arrays are not allocated if open() failed early.
+            if ( NULL != m_handle->apKeyDescriptor ) {
+                ::free( m_handle->apKeyDescriptor[ i ].apSegment );
+            }
+
+            if ( NULL != m_handle->apKeyIndex ) {
+                ::free( m_handle->apKeyIndex[ i ].apRecord );
+                ::free( m_handle->apKeyIndex[ i ].apSortedKey );
+                ::free( m_handle->apKeyIndex[ i ].apLayoutKey );
+                ::free( m_handle->apKeyIndex[ i ].apLayoutPosition );
+            }
         }
 
         ::free( m_handle->apKeyDescriptor );
@@ -555,7 +968,7 @@ bool OSNDXFIO::close()
         m_handle = NULL;
     }
 
-    return ( m_error != NO_DATABASE );
+    return ( synced && ( m_error != NO_DATABASE ));
 }
 
 /*============================================================================*/
@@ -580,10 +993,25 @@ bool OSNDXFIO::rebuild( const STRING    in_databaseName,
     }
 
     OSNDXFIO rebuild_db;
-    bool statusOk = rebuild_db.create( in_databaseName, in_nrOfKeys, in_keyDescriptor,  nbOfRecords );
+    bool statusOk = rebuild_db.create( in_databaseName, in_nrOfKeys, in_keyDescriptor,
+                                       U16( BOUND( U32( MINIMUM_RESERVED_INDEX_RECORDS ), nbOfRecords,
+                                                   U32( MAXIMUM_RESERVED_INDEX_RECORDS ))),
+                                       m_handle->options );
+
+    if ( !statusOk ) {
+        m_error = rebuild_db.getLastError();
+    }
 
     sRECORD record;
-    record.pData = pData;
+    record.allocatedSize = in_maxDataSize;
+    record.pData         = pData;
+
+    // The data region is read in index order, it is read ahead.
+    if ( statusOk ) {
+        adviseAccess( m_handle, OSFIO::ADVICE_SEQUENTIAL );
+        (void)m_handle->fileHandle.advise( OSFIO::ADVICE_WILLNEED );
+        m_handle->scanLength = SCAN_LENGTH;
+    }
 
     U32 index;
     for ( index = 0; statusOk && ( index < m_handle->nrOfIndexRecords ); index++ ) {
@@ -592,13 +1020,27 @@ bool OSNDXFIO::rebuild( const STRING    in_databaseName,
             U32 temp;
 
             if ( in_maxDataSize < pIndex->dataSize ) {
+                BYTE* pDataNew = (BYTE*)::realloc( pData, pIndex->dataSize );
+
+                if ( NULL == pDataNew ) {
+                    m_error = MEMORY_ALLOCATION_ERROR;
+                    statusOk = false;
+                    break;
+                }
+
                 in_maxDataSize       = pIndex->dataSize;
+                pData                = pDataNew;
                 record.allocatedSize = in_maxDataSize;
-                record.pData         = (BYTE*)::realloc( pData, in_maxDataSize );
+                record.pData         = pData;
             }
 
+            record.dataOffset = 0;
             statusOk = getRecord( index, record );
             statusOk = statusOk && rebuild_db.createRecord( record, temp );
+
+            if ( !statusOk && ( NO_ERROR == m_error )) {
+                m_error = rebuild_db.getLastError();
+            }
         }
     }
 
@@ -608,6 +1050,145 @@ bool OSNDXFIO::rebuild( const STRING    in_databaseName,
     return statusOk;
 }
 
+/*============================================================================*/
+bool OSNDXFIO::upgrade( const STRING in_databaseName,
+                        U32          in_maxDataSize )
+/*============================================================================*/
+{
+    if ( 0 == getNrOfRecords() ) {
+        OSNDXFIO upgrade_db;
+        // Nothing to copy, create an empty database of the current version.
+        bool statusOk = upgrade_db.create( in_databaseName,
+                                           m_handle->nrOfKeys,
+                                           m_handle->apKeyDescriptor,
+                                           m_handle->reservedIndexRecords );
+        m_error = upgrade_db.getLastError();
+        (void)upgrade_db.close();
+
+        return statusOk;
+    }
+
+    // m_error is set by rebuild().
+    return rebuild( in_databaseName,
+                    m_handle->nrOfKeys,
+                    m_handle->apKeyDescriptor,
+                    in_maxDataSize );
+}
+
+/*============================================================================*/
+bool OSNDXFIO::commit()
+/*============================================================================*/
+{
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk && ( m_handle->pendingChanges > 0 )) {
+        m_error  = DATABASE_IO_ERROR;
+        statusOk = syncChanges( m_handle );
+    }
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::getCacheStats( U64& out_rHits,
+                              U64& out_rMisses )
+/*============================================================================*/
+{
+    sCACHE_STATS stats;
+
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk ) {
+        m_error  = INVALID_PARAMETERS;
+        statusOk = m_handle->fileHandle.getCacheStats( stats );
+    }
+
+    if ( statusOk ) {
+        m_error     = NO_ERROR;
+        out_rHits   = stats.hits;
+        out_rMisses = stats.misses;
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::getIOStats( sIO_STATS& out_rStats )
+/*============================================================================*/
+{
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+        m_handle->fileHandle.getStats( out_rStats );
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::resetIOStats()
+/*============================================================================*/
+{
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+        m_handle->fileHandle.resetStats();
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::getKeyStats( U16         in_keyId,
+                            sKEY_STATS& out_rStats )
+/*============================================================================*/
+{
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk ) {
+        m_error  = INVALID_KEY_INDEX;
+        statusOk = ( in_keyId < m_handle->nrOfKeys );
+    }
+
+    if ( statusOk ) {
+        m_error    = NO_ERROR;
+        out_rStats = m_handle->apKeyIndex[ in_keyId ].stats;
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::setGrowth( U32 in_growthSize )
+/*============================================================================*/
+{
+    m_error = NO_DATABASE;
+    bool statusOk = ( NULL != m_handle );
+
+    if ( statusOk ) {
+        m_error  = INVALID_PARAMETERS;
+        statusOk = !m_handle->readOnly;
+    }
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+        m_handle->growthSize = in_growthSize;
+    }
+
+    return statusOk;
+}
+
 /*============================================================================*/
 U16 OSNDXFIO::getNrOfKeys()
 /*============================================================================*/
@@ -652,8 +1233,8 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
     }
 
     bool deletedRecordAvailable = ( m_handle->lastDeletedIndex >= 0 );
-    U32  indexOffset = deletedRecordAvailable ? m_handle->lastDeletedIndex :
-                       m_handle->nextFreeIndex;
+    S64  indexOffset = deletedRecordAvailable ? m_handle->lastDeletedIndex :
+                       S64( m_handle->nextFreeIndex );
 
     sDATA   data;
     sINDEX  index;
@@ -680,7 +1261,7 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
                 if ( in_rRecord.dataSize <= data.size ) {
                     // This record is not available anymore for overwriting.
                     deletedRecordAvailable  = false;
-                    header.lastDeletedIndex = (U32)index.prevDeletedIndex;
+                    header.lastDeletedIndex = index.prevDeletedIndex;
                 } else {
                     indexOffset = index.prevDeletedIndex;
 
@@ -714,15 +1295,29 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
     }
 
     if ( statusOk ) {
+        sIO_VECTOR dataVector[] = {
+            { &data, sizeof( data ) },
+            {( in_rRecord.pData + in_rRecord.dataOffset ), in_rRecord.dataSize }
+        };
+        sIO_VECTOR indexVector[] = {
+            { &index, sizeof( index ) },
+            { pSearchKey, header.totalKeySize }
+        };
+        U64 requiredEnd = header.nextFreeData + sizeof( data ) + in_rRecord.dataSize;
+
+        if (( header.nrOfRecords + 1 ) == m_handle->nrOfIndexRecords ) {
+            // A block of reserved index records follows the data.
+            requiredEnd += ( 2 * sizeof( data )) + ( m_handle->reservedIndexRecords *
+                           U64( sizeof( sINDEX ) + header.totalKeySize ));
+        }
+
+        growFile( m_handle, header, requiredEnd );
+
         m_error = DATABASE_IO_ERROR;
-        // Write data id record.
-        statusOk = m_handle->fileHandle.write( index.dataOffset, &data, sizeof( data ));
-        // Write data.
-        statusOk = statusOk && m_handle->fileHandle.write(( in_rRecord.pData + in_rRecord.dataOffset ), in_rRecord.dataSize );
-        // Write index record.
-        statusOk = statusOk && m_handle->fileHandle.write( index.offset, &index, sizeof( index ));
-        // Write index key.
-        statusOk = statusOk && m_handle->fileHandle.write( pSearchKey, header.totalKeySize );
+        // Write data id record and data.
+        statusOk = m_handle->fileHandle.write( index.dataOffset, dataVector, 2 );
+        // Write index record and index key.
+        statusOk = statusOk && m_handle->fileHandle.write( index.offset, indexVector, 2 );
     }
 
     if ( statusOk ) {
@@ -747,9 +1342,9 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
                 // Set the next free index file pointer. Temporary storage.
                 header.nextFreeIndex = header.nextFreeData;
                 // Update free data file pointer from current file pointer.
-                statusOk = (( header.nextFreeData = m_handle->fileHandle.position() ) != (U32)INVALID_VALUE );
+                statusOk = (( header.nextFreeData = m_handle->fileHandle.position() ) != (U64)INVALID_VALUE );
                 // Calculate the offset for the next index record and retrieve it.
-                U32 nextIndexOffset = ( m_handle->nextFreeIndex + sizeof( index ) + header.totalKeySize );
+                U64 nextIndexOffset = ( m_handle->nextFreeIndex + sizeof( index ) + header.totalKeySize );
                 statusOk = statusOk && m_handle->fileHandle.read( nextIndexOffset, &data, sizeof( data ));
                 statusOk = statusOk && ( data.id == eNEXT_INDEX );
                 // Set the next index record values.
@@ -771,6 +1366,9 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
         // Update file header.
         statusOk = statusOk && m_handle->fileHandle.write( sizeof( data ), &header,
                    sizeof( header ));
+        // Write buffered data of this record.
+        statusOk = statusOk && m_handle->fileHandle.flush();
+        statusOk = statusOk && commitChange( m_handle );
         // Bitwise copy to first field of sHEADER part of sHANDLE!
         ::memcpy(&m_handle->version, &header, sizeof( header ));
 
@@ -786,7 +1384,7 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
     }
 
     if ( statusOk ) {
-        U32 prevNrOfRecords = header.nrOfRecords;
+        U32 prevNrOfRecords = header.nrOfRecords - 1;
         U32 indexOffset     = prevNrOfRecords * m_handle->totalIndexSize;
 
         // Update apRecord index array and apKey array in memory.
@@ -794,8 +1392,11 @@ bool OSNDXFIO::createRecord( sRECORD& in_rRecord,
         ::memcpy(( m_handle->apKey + indexOffset + sizeof( index )),
                  pSearchKey, m_handle->totalKeySize);
 
+        // Sorted key indices stay sorted, lookups need no sort.
         for ( U16 k = 0; k < m_handle->nrOfKeys; k++ ) {
-            m_handle->apKeyIndex[ k ].bSorted = false;
+            if ( m_handle->apKeyIndex[ k ].bSorted ) {
+                insertKeyIndex( m_handle, k, prevNrOfRecords, prevNrOfRecords );
+            }
         }
 
         m_error     = NO_ERROR;
@@ -826,9 +1427,20 @@ bool OSNDXFIO::getRecord( U32      in_index,
 
     sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_index ));
 
+    // Small steps up in index order are a scan, other reads are lookups.
+    if (( in_index - ( m_handle->lastIndex + 1 )) < SCAN_GAP ) {
+        m_handle->scanLength = MIN(( m_handle->scanLength + 1 ), U32( SCAN_LENGTH ));
+    } else {
+        m_handle->scanLength = 0;
+    }
+
+    m_handle->lastIndex = in_index;
+    adviseAccess( m_handle, ( m_handle->scanLength >= SCAN_LENGTH ) ?
+                  OSFIO::ADVICE_SEQUENTIAL : OSFIO::ADVICE_RANDOM );
+
     sDATA data;
     // Read data id record.
-    bool statusOk = ( m_handle->fileHandle.read( pIndex->dataOffset, &data, sizeof( data )));
+    bool statusOk = readDataRecord( m_handle, pIndex->dataOffset, data );
 
     if ( statusOk ) {
         m_error  = INDEX_CORRUPT;
@@ -846,12 +1458,12 @@ bool OSNDXFIO::getRecord( U32      in_index,
         m_error = DATABASE_IO_ERROR;
         // Read data record.
         statusOk = ( m_handle->fileHandle.read(( pIndex->dataOffset +
-                                               sizeof( data )), out_rRecord.pData, data.size ));
+                                               m_handle->fileDataSize ), out_rRecord.pData, U32( data.size )));
     }
 
     if ( statusOk ) {
-        out_rRecord.dataOffset = pIndex->dataOffset + sizeof( data );
-        out_rRecord.dataSize = data.size;
+        out_rRecord.dataOffset = 0; // Data is read to the start of pData.
+        out_rRecord.dataSize = U32( data.size );
         m_error = NO_ERROR;
     }
 
@@ -859,28 +1471,9 @@ bool OSNDXFIO::getRecord( U32      in_index,
 }
 
 /*============================================================================*/
-bool OSNDXFIO::getNextRecord( U16      in_keyId,
-                              sRECORD& out_rRecord,
-                              U32&     out_rIndex )
-/*============================================================================*/
-{
-    m_error = ENTRY_NOT_FOUND;
-    bool statusOk = ( m_handle->apKeyIndex[ in_keyId ].position !=
-                      m_handle->apKeyIndex[ in_keyId ].selectionEnd );
-    out_rIndex = INVALID_VALUE;
-
-    if ( statusOk ) {
-        out_rIndex = m_handle->apKeyIndex[ in_keyId ].
-                     apRecord[ m_handle->apKeyIndex[ in_keyId ].position ];
-        m_handle->apKeyIndex[ in_keyId ].position++;
-        statusOk = getRecord( out_rIndex, out_rRecord );
-    }
-
-    return statusOk;
-}
-
-/*============================================================================*/
-bool OSNDXFIO::deleteRecord( U32 in_index )
+bool OSNDXFIO::getRecordView( U32          in_index,
+                              const BYTE*& out_rpData,
+                              U32&         out_rDataSize )
 /*============================================================================*/
 {
     m_error        = ENTRY_NOT_FOUND;
@@ -889,67 +1482,217 @@ bool OSNDXFIO::deleteRecord( U32 in_index )
 
     statusOk = statusOk && ( eOK == pIndex->status );
 
+    if ( statusOk ) {
+        m_error  = NOT_MAPPED;
+        statusOk = ( NULL != m_handle->fileHandle.view( pIndex->dataOffset,
+                                                        m_handle->fileDataSize ));
+    }
+
     sDATA data;
     if ( statusOk ) {
         m_error = DATABASE_IO_ERROR;
-        // Read data id record.
-        statusOk = ( m_handle->fileHandle.read( pIndex->dataOffset, &data, sizeof( data )));
+        // Read data id record, copied from the mapping.
+        statusOk = readDataRecord( m_handle, pIndex->dataOffset, data );
     }
 
     if ( statusOk ) {
-        m_error = INDEX_CORRUPT;
+        m_error  = INDEX_CORRUPT;
         // Verify data type and record reference.
         statusOk = (( data.id >= S32( eDATA )) && ( data.recordRef == pIndex->recordRef ));
     }
 
+    const BYTE* pData = NULL;
     if ( statusOk ) {
-        m_error = DATABASE_IO_ERROR;
-        data.id = eDELETED;
-        // Write data id record.
-        statusOk = m_handle->fileHandle.write( pIndex->dataOffset, &data, sizeof( data ));
-        // Write index record.
-        statusOk = statusOk && m_handle->fileHandle.write( pIndex->offset, pIndex, sizeof( sINDEX ));
+        m_error  = DATABASE_IO_ERROR;
+        pData    = m_handle->fileHandle.view(( pIndex->dataOffset + m_handle->fileDataSize ),
+                                             U32( data.size ));
+        statusOk = ( NULL != pData );
     }
 
     if ( statusOk ) {
-        m_error = NO_ERROR;
-        pIndex->prevDeletedIndex   = m_handle->lastDeletedIndex;
-        m_handle->lastDeletedIndex = in_index;
+        out_rpData    = pData;
+        out_rDataSize = U32( data.size );
+        m_error       = NO_ERROR;
     }
 
     return statusOk;
 }
 
 /*============================================================================*/
-bool OSNDXFIO::updateRecord( U32      in_index,
-                             sRECORD& in_rRecord )
+bool OSNDXFIO::getRecords( U32        in_count,
+                           const U32* in_pIndex,
+                           sRECORD*   out_pRecord )
 /*============================================================================*/
 {
-    m_error        = ENTRY_NOT_FOUND;
-    sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_index ));
-    bool  statusOk = ( in_index < m_handle->nrOfIndexRecords );
+    if ( m_handle->fileDataSize != sizeof( sDATA )) {
+        // Version 1 data records are widened, read one by one.
+        bool statusOk = true;
 
-    sDATA data;
-    if ( statusOk ) {
-        m_error = DATABASE_IO_ERROR;
-        // Read data id record.
-        statusOk = ( m_handle->fileHandle.read( pIndex->dataOffset, &data, sizeof( data )));
-    }
+        for ( U32 i = 0; statusOk && ( i < in_count ); i++ ) {
+            statusOk = getRecord( in_pIndex[ i ], out_pRecord[ i ] );
+        }
 
-    if ( statusOk ) {
-        m_error = INDEX_CORRUPT;
-        // Verify data type and record reference.
-        statusOk = (( data.id >= S32( eDATA )) && ( data.recordRef == pIndex->recordRef ));
-        statusOk = statusOk && ( pIndex->dataOffset == in_rRecord.dataOffset );
+        return statusOk;
     }
 
-    if ( statusOk ) {
-        m_error = RECORD_TOO_LARGE;
-        // Verify available data size.
-        statusOk = ( data.offset - ( pIndex->dataOffset + sizeof( data )) >= in_rRecord.dataSize );
-    }
+    bool statusOk = true;
 
-    BYTE* pSearchKey = (BYTE*)( ::malloc( m_handle->totalKeySize ));
+    for ( U32 i = 0; statusOk && ( i < in_count ); i++ ) {
+        U32     index  = in_pIndex[ i ];
+        sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * index ));
+
+        m_error  = ENTRY_NOT_FOUND;
+        statusOk = ( index < m_handle->nrOfIndexRecords ) && ( eOK == pIndex->status );
+
+        if ( statusOk ) {
+            m_error = RECORD_TOO_LARGE;
+            // Verify data allocated memory size.
+            statusOk = ( pIndex->dataSize <= out_pRecord[ i ].allocatedSize );
+        }
+    }
+
+    sDATA* pData = NULL;
+    if ( statusOk && ( in_count > 0 )) {
+        m_error  = MEMORY_ALLOCATION_ERROR;
+        pData    = (sDATA*)::malloc( in_count * sizeof( sDATA ));
+        statusOk = ( NULL != pData );
+    }
+
+    for ( U32 i = 0; statusOk && ( i < in_count ); i++ ) {
+        sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_pIndex[ i ] ));
+
+        // Queue data id record and data record.
+        statusOk = m_handle->fileHandle.queueRead( pIndex->dataOffset, &pData[ i ],
+                                                   sizeof( sDATA ));
+        statusOk = statusOk && m_handle->fileHandle.queueRead(
+                       ( pIndex->dataOffset + sizeof( sDATA )),
+                       out_pRecord[ i ].pData, pIndex->dataSize );
+    }
+
+    if ( statusOk ) {
+        m_error = DATABASE_IO_ERROR;
+    }
+
+    // Always submitted, the queue must be empty afterwards.
+    statusOk = m_handle->fileHandle.submit() && statusOk;
+
+    for ( U32 i = 0; statusOk && ( i < in_count ); i++ ) {
+        sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_pIndex[ i ] ));
+
+        m_error  = INDEX_CORRUPT;
+        // Verify data type, record reference and size.
+        statusOk = (( pData[ i ].id >= S32( eDATA )) &&
+                    ( pData[ i ].recordRef == pIndex->recordRef ) &&
+                    ( pData[ i ].size == pIndex->dataSize ));
+
+        if ( statusOk ) {
+            out_pRecord[ i ].dataOffset = 0; // Data is read to the start of pData.
+            out_pRecord[ i ].dataSize   = pIndex->dataSize;
+        }
+    }
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+    }
+
+    ::free( pData );
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::getNextRecord( U16      in_keyId,
+                              sRECORD& out_rRecord,
+                              U32&     out_rIndex )
+/*============================================================================*/
+{
+    m_error = ENTRY_NOT_FOUND;
+    bool statusOk = ( m_handle->apKeyIndex[ in_keyId ].position !=
+                      m_handle->apKeyIndex[ in_keyId ].selectionEnd );
+    out_rIndex = INVALID_VALUE;
+
+    if ( statusOk ) {
+        out_rIndex = m_handle->apKeyIndex[ in_keyId ].
+                     apRecord[ m_handle->apKeyIndex[ in_keyId ].position ];
+        m_handle->apKeyIndex[ in_keyId ].position++;
+        statusOk = getRecord( out_rIndex, out_rRecord );
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::deleteRecord( U32 in_index )
+/*============================================================================*/
+{
+    m_error        = ENTRY_NOT_FOUND;
+    sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_index ));
+    bool  statusOk = ( in_index < m_handle->nrOfIndexRecords );
+
+    statusOk = statusOk && ( eOK == pIndex->status );
+
+    sDATA data;
+    if ( statusOk ) {
+        m_error = DATABASE_IO_ERROR;
+        // Read data id record.
+        statusOk = readDataRecord( m_handle, pIndex->dataOffset, data );
+    }
+
+    if ( statusOk ) {
+        m_error = INDEX_CORRUPT;
+        // Verify data type and record reference.
+        statusOk = (( data.id >= S32( eDATA )) && ( data.recordRef == pIndex->recordRef ));
+    }
+
+    if ( statusOk ) {
+        m_error = DATABASE_IO_ERROR;
+        data.id = eDELETED;
+        // Write data id record.
+        statusOk = m_handle->fileHandle.write( pIndex->dataOffset, &data, sizeof( data ));
+        // Write index record.
+        statusOk = statusOk && m_handle->fileHandle.write( pIndex->offset, pIndex, sizeof( sINDEX ));
+        statusOk = statusOk && m_handle->fileHandle.flush();
+        statusOk = statusOk && commitChange( m_handle );
+    }
+
+    if ( statusOk ) {
+        m_error = NO_ERROR;
+        pIndex->prevDeletedIndex   = m_handle->lastDeletedIndex;
+        m_handle->lastDeletedIndex = in_index;
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+bool OSNDXFIO::updateRecord( U32      in_index,
+                             sRECORD& in_rRecord )
+/*============================================================================*/
+{
+    m_error        = ENTRY_NOT_FOUND;
+    sINDEX* pIndex = (sINDEX*)( m_handle->apKey + ( m_handle->totalIndexSize * in_index ));
+    bool  statusOk = ( in_index < m_handle->nrOfIndexRecords );
+
+    sDATA data;
+    if ( statusOk ) {
+        m_error = DATABASE_IO_ERROR;
+        // Read data id record.
+        statusOk = readDataRecord( m_handle, pIndex->dataOffset, data );
+    }
+
+    if ( statusOk ) {
+        m_error = INDEX_CORRUPT;
+        // Verify data type and record reference.
+        statusOk = (( data.id >= S32( eDATA )) && ( data.recordRef == pIndex->recordRef ));
+    }
+
+    if ( statusOk ) {
+        m_error = RECORD_TOO_LARGE;
+        // Verify available data size.
+        statusOk = ( data.offset - ( pIndex->dataOffset + sizeof( data )) >= in_rRecord.dataSize );
+    }
+
+    BYTE* pSearchKey = (BYTE*)( ::malloc( m_handle->totalKeySize ));
 
     if ( statusOk ) {
         if ( NULL == pSearchKey ) {
@@ -965,25 +1708,59 @@ bool OSNDXFIO::updateRecord( U32      in_index,
         m_error = DATABASE_IO_ERROR;
     }
 
-    sHEADER header = *m_handle;
-    // Write data.
-    statusOk = statusOk && m_handle->fileHandle.write(( in_rRecord.pData + in_rRecord.dataOffset ), in_rRecord.dataSize );
-    // Write index key.
-    statusOk = statusOk && m_handle->fileHandle.write( ( pIndex->offset + sizeof( sINDEX)), pSearchKey, header.totalKeySize );
+    sINDEX index = *pIndex;
 
     if ( statusOk ) {
-        U32 prevNrOfRecords = header.nrOfRecords;
-        U32 indexOffset     = prevNrOfRecords * m_handle->totalIndexSize;
+        // The allocated data size (data.offset) is kept.
+        data.size      = in_rRecord.dataSize;
+        index.dataSize = in_rRecord.dataSize;
+
+        sIO_VECTOR dataVector[] = {
+            { &data, sizeof( data ) },
+            {( in_rRecord.pData + in_rRecord.dataOffset ), in_rRecord.dataSize }
+        };
+        sIO_VECTOR indexVector[] = {
+            { &index, sizeof( index ) },
+            { pSearchKey, m_handle->totalKeySize }
+        };
+
+        // Write data id record and data.
+        statusOk = m_handle->fileHandle.write( index.dataOffset, dataVector, 2 );
+        // Write index record and index key.
+        statusOk = statusOk && m_handle->fileHandle.write( index.offset, indexVector, 2 );
+        statusOk = statusOk && m_handle->fileHandle.flush();
+        statusOk = statusOk && commitChange( m_handle );
+    }
 
-        // Update apRecord index array and apKey array in memory.
-        ::memcpy(( m_handle->apKey + indexOffset), pIndex, sizeof( sINDEX ));
-        ::memcpy(( m_handle->apKey + indexOffset + sizeof( sINDEX )),
-                 pSearchKey, m_handle->totalKeySize);
+    if ( statusOk ) {
+        U32 const nrOfRecords = m_handle->nrOfRecords;
 
+        /*--------------------------------------------------------------*/
+        /* Only key indices of a changed key are updated. The record    */
+        /* leaves a sorted key index by its old key and is inserted by  */
+        /* its new key.                                                 */
+        /*--------------------------------------------------------------*/
         for ( U16 k = 0; k < m_handle->nrOfKeys; k++ ) {
-            m_handle->apKeyIndex[ k ].bSorted = false;
+            sKEY_INDEX& keyIndex = m_handle->apKeyIndex[ k ];
+            BYTE*       pOldKey  = (BYTE*)pIndex + keyIndex.keyOffset;
+            const BYTE* pNewKey  = pSearchKey + ( keyIndex.keyOffset - sizeof( sINDEX ));
+
+            if ( keyIndex.pfCompare( pOldKey, pNewKey, keyIndex.keySize ) != 0 ) {
+                if ( keyIndex.bSorted ) {
+                    keyIndex.bSorted = removeKeyIndex( m_handle, k, in_index, nrOfRecords );
+                }
+
+                ::memcpy( pOldKey, pNewKey, keyIndex.keySize );
+
+                if ( keyIndex.bSorted ) {
+                    insertKeyIndex( m_handle, k, in_index, ( nrOfRecords - 1 ));
+                }
+            }
         }
 
+        // Update apKey array in memory.
+        ::memcpy( pIndex, &index, sizeof( index ));
+
         m_error = NO_ERROR;
     }
 
@@ -1004,10 +1781,15 @@ bool OSNDXFIO::existRecord( sKEY& in_rKey,
         bResult = convertKey( in_rKey );
     }
 
+    if ( bResult && !m_handle->apKeyIndex[ in_rKey.id ].bSorted ) {
+        sortKeyIndices( m_handle, in_rKey.id, 1 );
+    }
+
     if ( bResult ) {
-        if ( !m_handle->apKeyIndex[ in_rKey.id ].bSorted ) {
-            shellSort( m_handle, in_rKey.id );
-        }
+        // The kernel of the key index, a partial key selects its own.
+        KEY_COMPARE_FUNC* pfCompare = ( in_rKey.size == m_handle->apKeyIndex[ in_rKey.id ].keySize ) ?
+                                      m_handle->apKeyIndex[ in_rKey.id ].pfCompare :
+                                      selectKeyCompare( in_rKey.size );
 
         m_handle->apKeyIndex[ in_rKey.id ].position       = U32( INVALID_VALUE );
         m_handle->apKeyIndex[ in_rKey.id ].selectionStart = U32( INVALID_VALUE );
@@ -1015,9 +1797,9 @@ bool OSNDXFIO::existRecord( sKEY& in_rKey,
         out_rIndex                                        = U32( INVALID_VALUE );
 
         if ( m_handle->nrOfRecords == 1 ) {
-            bResult = ( ::memcmp( in_rKey.pValue,
-                                  ( m_handle->apKey + m_handle->apKeyIndex[ in_rKey.id ].keyOffset ),
-                                  in_rKey.size ) == 0 );
+            bResult = ( pfCompare( in_rKey.pValue,
+                                   ( m_handle->apKey + m_handle->apKeyIndex[ in_rKey.id ].keyOffset ),
+                                   in_rKey.size ) == 0 );
 
             if ( bResult ) {
                 m_handle->apKeyIndex[ in_rKey.id ].position       = 0;
@@ -1037,55 +1819,49 @@ bool OSNDXFIO::existRecord( sKEY& in_rKey,
 
             if ( in_rKey.index != U32( INVALID_VALUE )) {
                 leftIndex  = in_rKey.index;
-                rightIndex = ( in_rKey.index + in_rKey.count );
+                rightIndex = MIN( S32( in_rKey.index + in_rKey.count ), maxIndex );
             }
 
-            do {
-                searchIndex = U32(( leftIndex + rightIndex ) >> 1 ); // Division by 2.
-                result = ::memcmp( in_rKey.pValue,
-                                   ( m_handle->apKey +
-                                     ( m_handle->apKeyIndex[ in_rKey.id ].apRecord[ searchIndex ] *
-                                       m_handle->totalIndexSize ) +
-                                     m_handle->apKeyIndex[ in_rKey.id ].keyOffset ),
-                                   in_rKey.size );
-
-                if ( result < 0 ) {
-                    rightIndex = searchIndex - 1;
-                }
+            if (( in_rKey.index == U32( INVALID_VALUE )) &&
+                ( NULL != m_handle->apKeyIndex[ in_rKey.id ].apLayoutKey )) {
+                // The first key not less than the search key.
+                searchIndex = lowerBoundLayout( m_handle, in_rKey, pfCompare );
 
-                if ( result > 0 ) {
-                    leftIndex = searchIndex + 1;
+                if ( searchIndex > U32( maxIndex )) {
+                    searchIndex = U32( maxIndex );
+                    result      = 1;
+                } else {
+                    result = pfCompare( in_rKey.pValue,
+                                        sortedKey( m_handle, in_rKey.id, searchIndex ),
+                                        in_rKey.size );
                 }
+            } else {
+                do {
+                    searchIndex = U32(( leftIndex + rightIndex ) >> 1 ); // Division by 2.
+                    result = pfCompare( in_rKey.pValue,
+                                        sortedKey( m_handle, in_rKey.id, searchIndex ),
+                                        in_rKey.size );
+
+                    if ( result < 0 ) {
+                        rightIndex = searchIndex - 1;
+                    }
+
+                    if ( result > 0 ) {
+                        leftIndex = searchIndex + 1;
+                    }
 
-            } while (( result != 0 ) && (leftIndex <= rightIndex));
+                } while (( result != 0 ) && (leftIndex <= rightIndex));
+            }
 
             if ( result == 0 ) {
-                leftIndex = searchIndex;
                 // Find matching keys before searchIndex.
-                while (( leftIndex > 0 ) &&
-                        ( ::memcmp( in_rKey.pValue,
-                                    ( m_handle->apKey +
-                                      ( m_handle->apKeyIndex[ in_rKey.id ].apRecord[ leftIndex - 1 ] *
-                                        m_handle->totalIndexSize ) +
-                                      m_handle->apKeyIndex[ in_rKey.id ].keyOffset ),
-                                    in_rKey.size ) == 0 )) {
-                    leftIndex--;
-                }
+                leftIndex = S32( gallopMatches( m_handle, in_rKey, pfCompare, searchIndex, 0 ));
 
                 m_handle->apKeyIndex[ in_rKey.id ].position       = U32( leftIndex );
                 m_handle->apKeyIndex[ in_rKey.id ].selectionStart = U32( leftIndex );
 
-                rightIndex = searchIndex;
                 // Find matching keys beyond searchIndex.
-                while (( rightIndex < maxIndex ) &&
-                        ( ::memcmp( in_rKey.pValue,
-                                    ( m_handle->apKey +
-                                      ( m_handle->apKeyIndex[ in_rKey.id ].apRecord[ rightIndex + 1 ] *
-                                        m_handle->totalIndexSize ) +
-                                      m_handle->apKeyIndex[ in_rKey.id ].keyOffset ),
-                                    in_rKey.size ) == 0 )) {
-                    rightIndex++;
-                }
+                rightIndex = S32( gallopMatches( m_handle, in_rKey, pfCompare, searchIndex, U32( maxIndex )));
 
                 m_handle->apKeyIndex[ in_rKey.id ].selectionEnd = U32( rightIndex );
 
@@ -1174,7 +1950,7 @@ OSNDXFIO::eERROR OSNDXFIO::getLastError()
 static bool isDatabaseNameValid( const STRING in_databaseName )
 /*============================================================================*/
 {
-    return (( NULL != in_databaseName ) && ( "\0" != in_databaseName ));
+    return (( NULL != in_databaseName ) && ( '\0' != in_databaseName[ 0 ] ));
 }
 
 /*============================================================================*/
@@ -1319,123 +2095,1194 @@ static bool initKeyArray( OSNDXFIO::sHANDLE* pHandle )
     return statusOk;
 }
 
+/*============================================================================*/
+static void growFile( OSNDXFIO::sHANDLE* pHandle,
+                      sHEADER&           header,
+                      U64                requiredEnd )
+/*============================================================================*/
+{
+    U64 allocatedEnd = MAX( header.allocatedEnd, header.nextFreeData );
+
+    if (( 0 == pHandle->growthSize ) || ( requiredEnd <= allocatedEnd )) {
+        return;
+    }
+
+    U64 newEnd = requiredEnd + pHandle->growthSize;
+
+    // Optional, without support the file grows by writes.
+    if ( pHandle->fileHandle.allocate( allocatedEnd, ( newEnd - allocatedEnd ))) {
+        header.allocatedEnd = newEnd;
+    } else {
+        pHandle->growthSize = 0;
+    }
+}
+
+/*============================================================================*/
+static void adviseAccess( OSNDXFIO::sHANDLE* pHandle,
+                          OSFIO::eADVICE     advice )
+/*============================================================================*/
+{
+    // Optional, announced when the access pattern changes.
+    if ( pHandle->advice != advice ) {
+        (void)pHandle->fileHandle.advise( advice );
+        pHandle->advice = advice;
+    }
+}
+
+/*============================================================================*/
+static bool commitChange( OSNDXFIO::sHANDLE* pHandle )
+/*============================================================================*/
+{
+    bool syncRequired = false;
+
+    pHandle->pendingChanges++;
+    pHandle->sortOrderChanged = true;
+
+    switch ( pHandle->options.durability ) {
+    case OSNDXFIO::DURABILITY_PERIODIC:
+        syncRequired = (( ::time( NULL ) - pHandle->lastSync ) >=
+                        time_t( pHandle->options.syncInterval ));
+        break;
+    case OSNDXFIO::DURABILITY_GROUP:
+        syncRequired = (( pHandle->options.groupSize > 0 ) &&
+                        ( pHandle->pendingChanges >= pHandle->options.groupSize ));
+        break;
+    default: // Synchronized by commit() or close().
+        break;
+    }
+
+    return ( !syncRequired || syncChanges( pHandle ));
+}
+
+/*============================================================================*/
+static bool syncChanges( OSNDXFIO::sHANDLE* pHandle )
+/*============================================================================*/
+{
+    bool statusOk = pHandle->fileHandle.sync();
+
+    if ( statusOk ) {
+        pHandle->pendingChanges = 0;
+        pHandle->lastSync       = ::time( NULL );
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+static bool readDataRecord( OSNDXFIO::sHANDLE* pHandle,
+                            U64                in_position,
+                            sDATA&             out_rData )
+/*============================================================================*/
+{
+    if ( pHandle->fileDataSize == sizeof( sDATA )) {
+        return pHandle->fileHandle.read( in_position, &out_rData, sizeof( out_rData ));
+    }
+
+    sDATA_V1 data;
+    bool statusOk = pHandle->fileHandle.read( in_position, &data, sizeof( data ));
+
+    if ( statusOk ) {
+        out_rData.id        = data.id;
+        out_rData.recordRef = data.recordRef;
+        out_rData.size      = data.size; // Or nextIndexOffset.
+        out_rData.offset    = data.offset;
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+static bool readIndexRecords( OSNDXFIO::sHANDLE* pHandle,
+                              U64                in_position,
+                              U32                in_count,
+                              BYTE*              out_pIndex )
+/*============================================================================*/
+{
+    if ( pHandle->fileIndexSize == pHandle->totalIndexSize ) {
+        // Same layout in the file and in memory.
+        return pHandle->fileHandle.read( in_position, out_pIndex,
+                                         ( in_count * pHandle->totalIndexSize ));
+    }
+
+    // Read the version 1 index records, the application key follows.
+    BYTE* pBlock   = (BYTE*)::malloc( in_count * pHandle->fileIndexSize );
+    bool  statusOk = ( NULL != pBlock );
+
+    statusOk = statusOk && pHandle->fileHandle.read( in_position, pBlock,
+                                                     ( in_count * pHandle->fileIndexSize ));
+
+    for ( U32 i = 0; statusOk && ( i < in_count ); i++ ) {
+        const BYTE* pFileIndex = pBlock + ( i * pHandle->fileIndexSize );
+        BYTE*       pIndex     = out_pIndex + ( i * pHandle->totalIndexSize );
+        sINDEX_V1   indexV1;
+        sINDEX      index;
+
+        ::memcpy( &indexV1, pFileIndex, sizeof( indexV1 ));
+
+        index.status     = indexV1.status; // Or prevDeletedIndex.
+        index.offset     = indexV1.offset;
+        index.dataOffset = ( indexV1.dataOffset == U32( INVALID_VALUE )) ?
+                           U64( INVALID_VALUE ) : indexV1.dataOffset;
+        index.dataSize   = indexV1.dataSize;
+        index.recordRef  = indexV1.recordRef;
+        ::memcpy( pIndex, &index, sizeof( index ));
+        ::memcpy(( pIndex + sizeof( index )), ( pFileIndex + sizeof( indexV1 )),
+                 pHandle->totalKeySize );
+    }
+
+    ::free( pBlock );
+
+    return statusOk;
+}
+
 /*============================================================================*/
 static bool createReservedIndexRecords( OSFIO& handle,
-                                        U32    filePointer,
+                                        U64    filePointer,
                                         U16    reservedIndexRecords,
                                         U16    totalKeySize )
 /*============================================================================*/
 {
-    void* pKey           = malloc( totalKeySize );
-    bool  statusOk       = ( NULL != pKey );
-    sDATA record;
-    U32   indexOffset    = filePointer + sizeof( record /* index id */);
     U32   totalIndexSize = sizeof( sINDEX ) + totalKeySize;
+    U32   blockSize      = reservedIndexRecords * totalIndexSize;
+    BYTE* pBlock         = (BYTE*)::malloc( blockSize );
+    bool  statusOk       = ( NULL != pBlock );
+    sDATA record;
+    sDATA nextRecord;
+    U64   indexOffset    = filePointer + sizeof( record /* index id */);
 
     if ( statusOk ) {
-        ::memset( pKey, 0, totalKeySize ); // Initialize search key.
+        ::memset( pBlock, 0, blockSize ); // Initialize search keys.
 
         record.id     = eINDEX;
-        record.size   = reservedIndexRecords * totalIndexSize;
+        record.size   = blockSize;
         record.offset = indexOffset + record.size;
-    }
 
-    // Write data record with index id.
-    statusOk = statusOk && handle.write( filePointer,
-                                         &record,
-                                         sizeof( record ));
-    sINDEX index;
+        sINDEX index;
 
-    for ( U16 j = 0; statusOk && ( j < reservedIndexRecords ); j++ ) {
-        index.offset = indexOffset; // Write the index record.
-        statusOk     = statusOk && handle.write(&index, sizeof( index ));
-        statusOk     = statusOk && handle.write( pKey, totalKeySize );
+        for ( U16 j = 0; j < reservedIndexRecords; j++ ) {
+            index.offset = indexOffset; // Initialize the index record.
+            ::memcpy(( pBlock + ( j * totalIndexSize )), &index, sizeof( index ));
 
-        indexOffset += totalIndexSize;
-    }
+            indexOffset += totalIndexSize;
+        }
+
+        nextRecord.id              = eNEXT_INDEX;
+        nextRecord.nextIndexOffset = 0; // Initialize fields, there is no next
+        nextRecord.offset          = 0; // index block of reserved index yet.
 
-    ::free( pKey );
+        sIO_VECTOR vector[] = {
+            { &record, sizeof( record ) },  // Data record with index id.
+            { pBlock, blockSize },          // Reserved index records.
+            { &nextRecord, sizeof( nextRecord ) } // Data record with next index id.
+        };
 
-    record.id              = eNEXT_INDEX;
-    record.nextIndexOffset = 0; // Initialize fields, there is no next
-    record.offset          = 0; // index block of reserved index yet.
+        statusOk = handle.write( filePointer, vector, 3 );
+    }
 
-    // Write data record with next index id.
-    statusOk  = statusOk && handle.write( &record, sizeof( record ));
+    ::free( pBlock );
 
     return statusOk;
 }
 
 /*============================================================================*/
-static void shellSort( OSNDXFIO::sHANDLE* const pHandle,
-                       U16 const in_keyId  )
+static U64 indexChecksum( const OSNDXFIO::sHANDLE* pHandle )
 /*============================================================================*/
 {
-    U32 incrementalGap = 1;
-    U32 nrOfRecords = pHandle->nrOfRecords;
+    U64 checksum = 0xCBF29CE484222325ULL;
 
-    /*--------------------------------------------------------------*/
-    /* Compute the initial increment gap. The best algorithm is     */
-    /* unknown. Knuth's recommendation to compute the inc(k) is:    */
-    /* inc(1) = 1; inc(k+1) = 3*inc(k)+1; stop if inc(k+2) >= nelem */
-    /*--------------------------------------------------------------*/
-    if ( nrOfRecords <= 13 ) {
-        incrementalGap = 1; // Straight insertion sort.
-    } else {
-        do {
-            incrementalGap *= 3; // No check for potential overflow!
-            incrementalGap += 1;
-        } while ( incrementalGap < nrOfRecords );
+    // FNV-1a of the status, and of reference and key of valid index records.
+    // Reserved index records in memory differ from the file, they are left out.
+    for ( U32 i = 0; i < pHandle->nrOfRecords; i++ ) {
+        const sINDEX* pIndex = (const sINDEX*)( pHandle->apKey + ( pHandle->totalIndexSize * i ));
+        const BYTE*   pByte  = (const BYTE*)( pIndex + 1 );
+
+        checksum = ( checksum ^ U64( pIndex->status )) * 0x100000001B3ULL;
+
+        if ( pIndex->status == eOK ) {
+            checksum = ( checksum ^ pIndex->recordRef ) * 0x100000001B3ULL;
+
+            for ( U16 j = 0; j < pHandle->totalKeySize; j++ ) {
+                checksum = ( checksum ^ pByte[ j ] ) * 0x100000001B3ULL;
+            }
+        }
+    }
 
-        incrementalGap /= 3;
-        incrementalGap /= 3;
+    // And of the key indices, a damaged sort order is rejected as well.
+    for ( U16 keyId = 0; keyId < pHandle->nrOfKeys; keyId++ ) {
+        const U32* pRecord = pHandle->apKeyIndex[ keyId ].apRecord;
+
+        for ( U32 i = 0; i < pHandle->nrOfIndexRecords; i++ ) {
+            checksum = ( checksum ^ pRecord[ i ] ) * 0x100000001B3ULL;
+        }
     }
 
-    BYTE* apKey = pHandle->apKey;
-    U16 totalIndexSize = pHandle->totalIndexSize;
+    return checksum;
+}
 
-    /*--------------------------------------------------------------*/
-    /* Perform (diminishing increment) Shell Sort. Skip the inner   */
-    /* inner loop and redundant swap if elem_i is already sorted.   */
-    /*--------------------------------------------------------------*/
-    do {
-        for ( U32 i = incrementalGap; i < nrOfRecords; i++ ) {
-            U32  keyOffset      = pHandle->apKeyIndex[ in_keyId ].keyOffset;
-            U32  keySize        = pHandle->apKeyIndex[ in_keyId ].keySize;
-            U32  j = i;
-            U32  indexI         = pHandle->apKeyIndex[ in_keyId ].apRecord[ i ];
-            U32  indexJMinusInc = pHandle->apKeyIndex[ in_keyId ].apRecord[ j - incrementalGap ];
-            U32* pIndexJ        = &pHandle->apKeyIndex[ in_keyId ].apRecord[ j ];
-
-            if ( ::memcmp(( apKey + ( indexJMinusInc * totalIndexSize ) + keyOffset ),
-                          ( apKey + ( indexI * totalIndexSize ) + keyOffset ),
-                          keySize ) > 0 ) {
-                bool bMinusInc;
-                do {
-                    *pIndexJ = indexJMinusInc;
+/*============================================================================*/
+static char* sortOrderName( const OSNDXFIO::sHANDLE* pHandle )
+/*============================================================================*/
+{
+    char* pName = (char*)::malloc( ::strlen( pHandle->pDatabaseName ) +
+                                   sizeof( SORT_ORDER_EXTENSION ));
 
-                    j -= incrementalGap;
+    if ( NULL != pName ) {
+        ::strcpy( pName, pHandle->pDatabaseName );
+        ::strcat( pName, SORT_ORDER_EXTENSION );
+    }
 
-                    bMinusInc = ( j >= incrementalGap );
-                    pIndexJ = &pHandle->apKeyIndex[ in_keyId ].apRecord[ j ];
+    return pName;
+}
 
-                    if ( bMinusInc ) {
-                        indexJMinusInc = pHandle->apKeyIndex[ in_keyId ].apRecord[ j - incrementalGap ];
-                    }
-                } while ( bMinusInc &&
-                          ( ::memcmp(( apKey + ( indexJMinusInc * totalIndexSize ) + keyOffset ),
-                                     ( apKey + ( indexI * totalIndexSize ) + keyOffset ),
-                                     keySize ) > 0 ));
+/*============================================================================*/
+static bool loadSortOrder( OSNDXFIO::sHANDLE* pHandle )
+/*============================================================================*/
+{
+    char*       pName    = sortOrderName( pHandle );
+    OSFIO       file;
+    sSORT_ORDER header;
+    U32 const   keySize  = pHandle->nrOfIndexRecords * sizeof( U32 );
+    bool        statusOk = ( NULL != pName ) && file.open( pName, READ_ONLY_ACCESS );
+
+    statusOk = statusOk && file.read( 0, &header, sizeof( header ));
+
+    // The stamp rejects a stale file.
+    statusOk = statusOk &&
+               ( header.version == NDXFIO_VERSION ) &&
+               ( header.recordReference == pHandle->recordReference ) &&
+               ( header.nrOfRecords == pHandle->nrOfRecords ) &&
+               ( header.nrOfIndexRecords == pHandle->nrOfIndexRecords ) &&
+               ( header.nrOfKeys == pHandle->nrOfKeys ) &&
+               ( file.size() == ( sizeof( header ) + ( U64( keySize ) * pHandle->nrOfKeys )));
+
+    for ( U16 keyId = 0; ( statusOk && ( keyId < pHandle->nrOfKeys )); keyId++ ) {
+        U32* pRecord = pHandle->apKeyIndex[ keyId ].apRecord;
+
+        statusOk = file.read(( sizeof( header ) + ( U64( keySize ) * keyId )), pRecord, keySize );
+
+        for ( U32 i = 0; ( statusOk && ( i < pHandle->nrOfIndexRecords )); i++ ) {
+            statusOk = ( pRecord[ i ] < pHandle->nrOfIndexRecords );
+        }
+    }
+
+    // The checksum covers the loaded key indices, a damaged file is
+    // rejected. One pass per key verifies the order, far below a sort.
+    statusOk = statusOk && ( header.checksum == indexChecksum( pHandle ));
+
+    for ( U16 keyId = 0; ( statusOk && ( keyId < pHandle->nrOfKeys )); keyId++ ) {
+        statusOk = isKeyIndexSorted( pHandle, keyId );
+    }
 
-                *pIndexJ = indexI;
+    (void)file.close();
+    ::free( pName );
+
+    for ( U16 keyId = 0; keyId < pHandle->nrOfKeys; keyId++ ) {
+        sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ keyId ];
+
+        if ( statusOk ) {
+            keyIndex.bSorted = true;
+            buildSortedKeys( pHandle, keyId, pHandle->nrOfRecords );
+        } else {
+            // Restore the unsorted key index.
+            for ( U32 i = 0; i < pHandle->nrOfIndexRecords; i++ ) {
+                keyIndex.apRecord[ i ] = i;
             }
         }
+    }
 
-        incrementalGap /= 3;
-
-    } while ( incrementalGap > 0 );
+    return statusOk;
+}
 
-    pHandle->apKeyIndex[ in_keyId ].bSorted = true;
+/*============================================================================*/
+static bool isKeyIndexSorted( const OSNDXFIO::sHANDLE* pHandle,
+                              U16                      in_keyId )
+/*============================================================================*/
+{
+    const sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+    sSORT_CONTEXT     context;
+    bool              bSorted  = true;
+
+    context.pKey           = pHandle->apKey + keyIndex.keyOffset;
+    context.totalIndexSize = pHandle->totalIndexSize;
+    context.keySize        = keyIndex.keySize;
+    context.pfCompare      = keyIndex.pfCompare;
+
+    // Strictly ascending by key and record, which rejects duplicate entries.
+    for ( U32 i = 1; ( bSorted && ( i < pHandle->nrOfRecords )); i++ ) {
+        bSorted = isLess( context, keyIndex.apRecord[ i - 1 ], keyIndex.apRecord[ i ] );
+    }
+
+    return bSorted;
+}
+
+/*============================================================================*/
+static bool saveSortOrder( OSNDXFIO::sHANDLE* pHandle )
+/*============================================================================*/
+{
+    char*       pName   = sortOrderName( pHandle );
+    OSFIO       file;
+    sSORT_ORDER header;
+    U32 const   keySize = pHandle->nrOfIndexRecords * sizeof( U32 );
+    bool        statusOk = ( NULL != pName );
+
+    for ( U16 keyId = 0; keyId < pHandle->nrOfKeys; keyId++ ) {
+        if ( !pHandle->apKeyIndex[ keyId ].bSorted ) {
+            sortKeyIndices( pHandle, keyId, 1 );
+        }
+    }
+
+    header.recordReference  = pHandle->recordReference;
+    header.nrOfRecords      = pHandle->nrOfRecords;
+    header.nrOfIndexRecords = pHandle->nrOfIndexRecords;
+    header.nrOfKeys         = pHandle->nrOfKeys;
+    header.checksum         = indexChecksum( pHandle );
+
+    // The file is replaced, see OSNDXFIO::create().
+    if ( statusOk ) {
+        (void)OSFIO::erase( pName );
+        statusOk = file.create( pName ) && file.close();
+    }
+
+    statusOk = statusOk && file.open( pName, READ_WRITE_ACCESS );
+    statusOk = statusOk && file.write( 0, &header, sizeof( header ));
+
+    for ( U16 keyId = 0; ( statusOk && ( keyId < pHandle->nrOfKeys )); keyId++ ) {
+        statusOk = file.write(( sizeof( header ) + ( U64( keySize ) * keyId )),
+                              pHandle->apKeyIndex[ keyId ].apRecord, keySize );
+    }
+
+    statusOk = file.close() && statusOk;
+
+    if ( statusOk ) {
+        pHandle->sortOrderChanged = false;
+    } else if ( NULL != pName ) {
+        // A partial file is rejected by its size, it is removed anyway.
+        (void)OSFIO::erase( pName );
+    }
+
+    ::free( pName );
+
+    return statusOk;
+}
+
+/*============================================================================*/
+static KEY_COMPARE_FUNC* selectKeyCompare( U32 in_keySize )
+/*============================================================================*/
+{
+    /*--------------------------------------------------------------*/
+    /* Converted keys are big endian, loaded as unsigned words they */
+    /* compare like memcmp(). Single tU16 and tU32 keys compare by  */
+    /* one instruction, keys of 8 byte words word by word.          */
+    /*--------------------------------------------------------------*/
+    switch ( in_keySize ) {
+    case sizeof( U16 ):
+        return compareKey< U16, 1 >;
+    case sizeof( U32 ):
+        return compareKey< U32, 1 >;
+    case sizeof( U64 ):
+        return compareKey< U64, 1 >;
+    case ( 2 * sizeof( U64 )):
+        return compareKey< U64, 2 >;
+    default:
+        break;
+    }
+
+    if (( in_keySize % sizeof( U64 )) == 0 ) {
+        return compareKey< U64, 0 >; // Word count by in_size.
+    }
+
+    return compareBytes;
+}
+
+/*============================================================================*/
+template <typename WORD, U32 NR_OF_WORDS>
+static int compareKey( const BYTE* pKeyA,
+                       const BYTE* pKeyB,
+                       U32         in_size )
+/*============================================================================*/
+{
+    U32 const nrOfWords = ( NR_OF_WORDS > 0 ) ? NR_OF_WORDS : U32( in_size / sizeof( WORD ));
+
+    for ( U32 i = 0; i < nrOfWords; i++ ) {
+        WORD wordA;
+        WORD wordB;
+
+        loadWord( pKeyA, wordA );
+        loadWord( pKeyB, wordB );
+
+        if ( wordA != wordB ) {
+            return (( wordA < wordB ) ? -1 : 1 );
+        }
+
+        pKeyA += sizeof( WORD );
+        pKeyB += sizeof( WORD );
+    }
+
+    return 0;
+}
+
+/*============================================================================*/
+static int compareBytes( const BYTE* pKeyA,
+                         const BYTE* pKeyB,
+                         U32         in_size )
+/*============================================================================*/
+{
+    return ::memcmp( pKeyA, pKeyB, in_size );
+}
+
+/*============================================================================*/
+static inline void loadWord( const BYTE* pKey,
+                             U16&        out_rWord )
+/*============================================================================*/
+{
+    ::memcpy( &out_rWord, pKey, sizeof( out_rWord ));
+#ifndef CPU_BIG_ENDIAN    // Default CPU_LITTLE_ENDIAN!
+    out_rWord = U16(( out_rWord >> 8 ) | ( out_rWord << 8 ));
+#endif
+}
+
+/*============================================================================*/
+static inline void loadWord( const BYTE* pKey,
+                             U32&        out_rWord )
+/*============================================================================*/
+{
+    ::memcpy( &out_rWord, pKey, sizeof( out_rWord ));
+#ifndef CPU_BIG_ENDIAN    // Default CPU_LITTLE_ENDIAN!
+    out_rWord = (( out_rWord >> 24 ) | (( out_rWord >> 8 ) & 0x0000FF00 ) |
+                 (( out_rWord << 8 ) & 0x00FF0000 ) | ( out_rWord << 24 ));
+#endif
+}
+
+/*============================================================================*/
+static inline void loadWord( const BYTE* pKey,
+                             U64&        out_rWord )
+/*============================================================================*/
+{
+    U32 high;
+    U32 low;
+
+    loadWord( pKey, high );
+    loadWord( pKey + sizeof( high ), low );
+    out_rWord = ( U64( high ) << 32 ) | low;
+}
+
+/*============================================================================*/
+static inline bool isLess( const sSORT_CONTEXT& context,
+                           U32                  recordA,
+                           U32                  recordB )
+/*============================================================================*/
+{
+    int result = context.pfCompare(( context.pKey + ( size_t( recordA ) * context.totalIndexSize )),
+                                   ( context.pKey + ( size_t( recordB ) * context.totalIndexSize )),
+                                   context.keySize );
+
+    // Equal keys are ordered by record, all elements are distinct.
+    return (( result < 0 ) || (( result == 0 ) && ( recordA < recordB )));
+}
+
+/*============================================================================*/
+static inline bool isLess( const sSORT_CONTEXT& context,
+                           const sKEY_ENTRY&    entryA,
+                           const sKEY_ENTRY&    entryB )
+/*============================================================================*/
+{
+    if ( entryA.prefix != entryB.prefix ) {
+        return ( entryA.prefix < entryB.prefix );
+    }
+
+    // Equal prefixes, a longer key is compared by its kernel.
+    if ( context.keySize > sizeof( entryA.prefix )) {
+        int result = context.pfCompare(( context.pKey + ( size_t( entryA.record ) * context.totalIndexSize )),
+                                       ( context.pKey + ( size_t( entryB.record ) * context.totalIndexSize )),
+                                       context.keySize );
+
+        if ( result != 0 ) {
+            return ( result < 0 );
+        }
+    }
+
+    return ( entryA.record < entryB.record );
+}
+
+#ifdef OSFIO_LINUX
+/*============================================================================*/
+static void* sortWorker( void* pArgument )
+/*============================================================================*/
+{
+    sSORT_POOL* pPool = (sSORT_POOL*)pArgument;
+
+    (void)::pthread_mutex_lock( &pPool->mutex );
+
+    for ( ;; ) {
+        while (( pPool->nrOfTasks == 0 ) && ( pPool->nrOfBusy > 0 )) {
+            (void)::pthread_cond_wait( &pPool->condition, &pPool->mutex );
+        }
+
+        if ( pPool->nrOfTasks == 0 ) {
+            break; // All keys sorted.
+        }
+
+        sSORT_TASK task = pPool->pTask[ --pPool->nrOfTasks ];
+        pPool->nrOfBusy++;
+        (void)::pthread_mutex_unlock( &pPool->mutex );
+
+        // Hand the larger part of a large partition to another worker.
+        while ((( task.pLast - task.pFirst ) > PARALLEL_SORT ) && ( task.depthLimit > 0 )) {
+            sKEY_ENTRY* pSplit = partition( task.context, task.pFirst, task.pLast );
+            sSORT_TASK other( task );
+
+            task.depthLimit--;
+            other.depthLimit = task.depthLimit;
+
+            if (( pSplit - task.pFirst ) < ( task.pLast - pSplit )) {
+                other.pFirst = pSplit;
+                task.pLast   = pSplit;
+            } else {
+                other.pLast  = pSplit;
+                task.pFirst  = pSplit;
+            }
+
+            (void)::pthread_mutex_lock( &pPool->mutex );
+            pPool->pTask[ pPool->nrOfTasks++ ] = other;
+            (void)::pthread_cond_signal( &pPool->condition );
+            (void)::pthread_mutex_unlock( &pPool->mutex );
+        }
+
+        sortRange( task.context, task.pFirst, task.pLast, task.depthLimit );
+
+        (void)::pthread_mutex_lock( &pPool->mutex );
+        pPool->nrOfBusy--;
+
+        if (( pPool->nrOfBusy == 0 ) && ( pPool->nrOfTasks == 0 )) {
+            (void)::pthread_cond_broadcast( &pPool->condition );
+        }
+    }
+
+    (void)::pthread_mutex_unlock( &pPool->mutex );
+
+    return NULL;
+}
+#endif
+
+/*============================================================================*/
+static inline const BYTE* sortedKey( const OSNDXFIO::sHANDLE* pHandle,
+                                     U16                      in_keyId,
+                                     U32                      in_position )
+/*============================================================================*/
+{
+    const sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+
+    if ( NULL != keyIndex.apSortedKey ) {
+        return ( keyIndex.apSortedKey + ( size_t( in_position ) * keyIndex.keySize ));
+    }
+
+    return ( pHandle->apKey + ( size_t( keyIndex.apRecord[ in_position ] ) * pHandle->totalIndexSize ) +
+             keyIndex.keyOffset );
+}
+
+/*============================================================================*/
+static void buildSortedKeys( OSNDXFIO::sHANDLE* pHandle,
+                             U16                in_keyId,
+                             U32                in_count )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+
+    if ( pHandle->options.keyArrays &&
+         reserveSortedKeys( pHandle, in_keyId, in_count )) {
+        BYTE* pKey = keyIndex.apSortedKey;
+
+        for ( U32 i = 0; i < in_count; i++ ) {
+            ::memcpy( pKey, ( pHandle->apKey + ( size_t( keyIndex.apRecord[ i ] ) * pHandle->totalIndexSize ) +
+                              keyIndex.keyOffset ), keyIndex.keySize );
+            pKey += keyIndex.keySize;
+        }
+    }
+}
+
+/*============================================================================*/
+static bool reserveSortedKeys( OSNDXFIO::sHANDLE* pHandle,
+                               U16                in_keyId,
+                               U32                in_count )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+
+    if ( !pHandle->options.keyArrays ) {
+        UNSUCCESSFUL_RETURN; // Exit reserveSortedKeys().
+    }
+
+    if ( in_count > keyIndex.sortedKeyCount ) {
+        // Grows by half, appended keys do not reallocate every record.
+        U32   count = MAX( in_count, ( keyIndex.sortedKeyCount + ( keyIndex.sortedKeyCount / 2 )));
+        U64   size  = U64( count ) * keyIndex.keySize;
+        BYTE* pKey  = NULL;
+
+        if ( size < MAX_MALLOC ) {
+            pKey = (BYTE*)::realloc( keyIndex.apSortedKey, size_t( MAX( size, U64( 1 ))));
+        }
+
+        if ( NULL == pKey ) {
+            // Without memory the keys are read by the index records.
+            ::free( keyIndex.apSortedKey );
+            keyIndex.apSortedKey    = NULL;
+            keyIndex.sortedKeyCount = 0;
+            UNSUCCESSFUL_RETURN; // Exit reserveSortedKeys().
+        }
+
+        keyIndex.apSortedKey    = pKey;
+        keyIndex.sortedKeyCount = count;
+    }
+
+    return true;
+}
+
+/*============================================================================*/
+static void buildSearchLayout( OSNDXFIO::sHANDLE* pHandle,
+                               U16                in_keyId )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+    U32 const   nrOfSlots = pHandle->nrOfRecords + 1; // Slot 0 is not used.
+
+    keyIndex.apLayoutKey      = (BYTE*)::malloc( size_t( nrOfSlots ) * keyIndex.keySize );
+    keyIndex.apLayoutPosition = (U32*)::malloc( size_t( nrOfSlots ) * sizeof( U32 ));
+
+    if (( NULL != keyIndex.apLayoutKey ) && ( NULL != keyIndex.apLayoutPosition )) {
+        (void)fillSearchLayout( pHandle, in_keyId, 0, 1 );
+    } else {
+        // Optional, existRecord() falls back to the binary search.
+        ::free( keyIndex.apLayoutKey );
+        ::free( keyIndex.apLayoutPosition );
+        keyIndex.apLayoutKey      = NULL;
+        keyIndex.apLayoutPosition = NULL;
+    }
+}
+
+/*============================================================================*/
+static U32 fillSearchLayout( const OSNDXFIO::sHANDLE* pHandle,
+                             U16                      in_keyId,
+                             U32                      in_position,
+                             U32                      in_slot )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+
+    /*--------------------------------------------------------------*/
+    /* An in-order walk of the implicit tree, the children of slot  */
+    /* k are 2k and 2k + 1. The sorted keys fill the slots in the   */
+    /* order of the walk, the recursion depth is log2( n ).         */
+    /*--------------------------------------------------------------*/
+    if ( in_slot <= pHandle->nrOfRecords ) {
+        in_position = fillSearchLayout( pHandle, in_keyId, in_position, ( 2 * in_slot ));
+
+        ::memcpy(( keyIndex.apLayoutKey + ( size_t( in_slot ) * keyIndex.keySize )),
+                 sortedKey( pHandle, in_keyId, in_position ), keyIndex.keySize );
+        keyIndex.apLayoutPosition[ in_slot ] = in_position++;
+
+        in_position = fillSearchLayout( pHandle, in_keyId, in_position, (( 2 * in_slot ) + 1 ));
+    }
+
+    return in_position;
+}
+
+/*============================================================================*/
+static U32 lowerBoundLayout( const OSNDXFIO::sHANDLE* pHandle,
+                             const OSNDXFIO::sKEY&    in_rKey,
+                             KEY_COMPARE_FUNC*        pfCompare )
+/*============================================================================*/
+{
+    const sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_rKey.id ];
+    U32 const         keySize  = keyIndex.keySize;
+    U32               slot     = 1;
+
+    // The descent has no data dependent branch, the slots of the next
+    // levels are fetched while the current key is compared.
+    while ( slot <= pHandle->nrOfRecords ) {
+        PREFETCH( keyIndex.apLayoutKey + ( size_t( slot ) * PREFETCH_SLOTS * keySize ));
+        slot = ( 2 * slot ) +
+               (( pfCompare(( keyIndex.apLayoutKey + ( size_t( slot ) * keySize )),
+                            in_rKey.pValue, in_rKey.size ) < 0 ) ? 1 : 0 );
+    }
+
+    // The last left turn is the lower bound, the right turns after it are undone.
+    while (( slot & 1 ) != 0 ) {
+        slot >>= 1;
+    }
+
+    slot >>= 1;
+
+    return (( slot == 0 ) ? pHandle->nrOfRecords : keyIndex.apLayoutPosition[ slot ] );
+}
+
+/*============================================================================*/
+static U32 gallopMatches( const OSNDXFIO::sHANDLE* pHandle,
+                          const OSNDXFIO::sKEY&    in_rKey,
+                          KEY_COMPARE_FUNC*        pfCompare,
+                          U32                      in_match,
+                          U32                      in_limit )
+/*============================================================================*/
+{
+    bool const downwards  = ( in_limit < in_match );
+    U32 const  distance   = downwards ? ( in_match - in_limit ) : ( in_limit - in_match );
+    U32        matched    = 0;            // Distance of a matching key.
+    U32        mismatched = distance + 1; // Distance of a different key.
+    U32        step       = 1;
+
+    /*--------------------------------------------------------------*/
+    /* Galloping: steps of 1, 2, 4, .. from the match bracket the   */
+    /* last matching key, a binary search finds it. n equal keys    */
+    /* cost 2 * log2( n ) comparisons instead of n.                 */
+    /*--------------------------------------------------------------*/
+    while (( step <= distance ) &&
+           ( pfCompare( in_rKey.pValue,
+                        sortedKey( pHandle, in_rKey.id, ( downwards ? ( in_match - step ) : ( in_match + step ))),
+                        in_rKey.size ) == 0 )) {
+        matched = step;
+        step   *= 2;
+    }
+
+    if ( step <= distance ) {
+        mismatched = step;
+    }
+
+    while (( mismatched - matched ) > 1 ) {
+        U32 middle = matched + (( mismatched - matched ) / 2 );
+
+        if ( pfCompare( in_rKey.pValue,
+                        sortedKey( pHandle, in_rKey.id, ( downwards ? ( in_match - middle ) : ( in_match + middle ))),
+                        in_rKey.size ) == 0 ) {
+            matched = middle;
+        } else {
+            mismatched = middle;
+        }
+    }
+
+    return ( downwards ? ( in_match - matched ) : ( in_match + matched ));
+}
+
+/*============================================================================*/
+static U32 searchKeyIndex( const OSNDXFIO::sHANDLE* pHandle,
+                           U16                      in_keyId,
+                           U32                      in_record,
+                           U32                      in_count )
+/*============================================================================*/
+{
+    sKEY_INDEX&   keyIndex = pHandle->apKeyIndex[ in_keyId ];
+    sSORT_CONTEXT context;
+    U32           first    = 0;
+    U32           last     = in_count;
+
+    context.pKey           = pHandle->apKey + keyIndex.keyOffset;
+    context.totalIndexSize = pHandle->totalIndexSize;
+    context.keySize        = keyIndex.keySize;
+    context.pfCompare      = keyIndex.pfCompare;
+
+    // Lower bound, ordered like sortKeyIndex() by key and record.
+    while ( first < last ) {
+        U32 middle = first + (( last - first ) / 2 );
+
+        if ( isLess( context, keyIndex.apRecord[ middle ], in_record )) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+/*============================================================================*/
+static void insertKeyIndex( OSNDXFIO::sHANDLE* pHandle,
+                            U16                in_keyId,
+                            U32                in_record,
+                            U32                in_count )
+/*============================================================================*/
+{
+    sKEY_INDEX&   keyIndex = pHandle->apKeyIndex[ in_keyId ];
+    U32*          pRecord  = keyIndex.apRecord;
+    sSORT_CONTEXT context;
+
+    context.pKey           = pHandle->apKey + keyIndex.keyOffset;
+    context.totalIndexSize = pHandle->totalIndexSize;
+    context.keySize        = keyIndex.keySize;
+    context.pfCompare      = keyIndex.pfCompare;
+
+    U32 position = in_count;
+
+    // Ascending keys are appended, no search and no move.
+    if (( in_count == 0 ) || isLess( context, pRecord[ in_count - 1 ], in_record )) {
+        keyIndex.stats.appends++;
+    } else {
+        position = searchKeyIndex( pHandle, in_keyId, in_record, in_count );
+        keyIndex.stats.inserts++;
+    }
+
+    // The entry behind the sorted entries is overwritten.
+    ::memmove(( pRecord + position + 1 ), ( pRecord + position ),
+              (( in_count - position ) * sizeof( *pRecord )));
+    pRecord[ position ] = in_record;
+
+    if (( NULL == keyIndex.apSortedKey ) && ( in_count > 0 )) {
+        // A key array dropped for lack of memory holds no keys, it is
+        // rebuilt from the key index instead of grown.
+        buildSortedKeys( pHandle, in_keyId, ( in_count + 1 ));
+    } else if ( reserveSortedKeys( pHandle, in_keyId, ( in_count + 1 ))) {
+        BYTE* pKey = keyIndex.apSortedKey + ( size_t( position ) * keyIndex.keySize );
+
+        ::memmove(( pKey + keyIndex.keySize ), pKey, (( in_count - position ) * keyIndex.keySize ));
+        ::memcpy( pKey, ( context.pKey + ( size_t( in_record ) * context.totalIndexSize )),
+                  keyIndex.keySize );
+    }
+}
+
+/*============================================================================*/
+static bool removeKeyIndex( OSNDXFIO::sHANDLE* pHandle,
+                            U16                in_keyId,
+                            U32                in_record,
+                            U32                in_count )
+/*============================================================================*/
+{
+    U32* pRecord  = pHandle->apKeyIndex[ in_keyId ].apRecord;
+    U32  position = searchKeyIndex( pHandle, in_keyId, in_record, in_count );
+    bool statusOk = (( position < in_count ) && ( pRecord[ position ] == in_record ));
+
+    // The record moves behind the remaining sorted entries.
+    if ( statusOk ) {
+        ::memmove(( pRecord + position ), ( pRecord + position + 1 ),
+                  (( in_count - position - 1 ) * sizeof( *pRecord )));
+        pRecord[ in_count - 1 ] = in_record;
+    }
+
+    if ( statusOk && ( NULL != pHandle->apKeyIndex[ in_keyId ].apSortedKey )) {
+        U16   keySize = pHandle->apKeyIndex[ in_keyId ].keySize;
+        BYTE* pKey    = pHandle->apKeyIndex[ in_keyId ].apSortedKey + ( size_t( position ) * keySize );
+
+        ::memmove( pKey, ( pKey + keySize ), (( in_count - position - 1 ) * keySize ));
+    }
+
+    return statusOk;
+}
+
+/*============================================================================*/
+static void sortKeyIndices( OSNDXFIO::sHANDLE* const pHandle,
+                            U16 const                in_firstKeyId,
+                            U16 const                in_nrOfKeys )
+/*============================================================================*/
+{
+    U32 const nrOfRecords = pHandle->nrOfRecords;
+    U16       keyId       = in_firstKeyId;
+
+#ifdef OSFIO_LINUX
+    /*--------------------------------------------------------------*/
+    /* The key indices are independent, a pool of workers sorts     */
+    /* them. A large partition is split into further tasks, which   */
+    /* sorts a single key index in parallel as well. The calling    */
+    /* thread is a worker, it sorts alone if no thread starts.      */
+    /*--------------------------------------------------------------*/
+    // Pending tasks are disjoint partitions of more than PARALLEL_SORT / 2 records.
+    U32 const maxTasks    = in_nrOfKeys * ((( 2 * nrOfRecords ) / PARALLEL_SORT ) + 1 );
+    U32 const nrOfThreads = MIN( pHandle->options.sortThreads, maxTasks );
+
+    if ( nrOfThreads > 1 ) {
+        sSORT_POOL  pool;
+        pthread_t*  pThread = (pthread_t*)::malloc( sizeof( pthread_t ) * nrOfThreads );
+        sKEY_ENTRY* pEntry  = (sKEY_ENTRY*)::malloc( sizeof( sKEY_ENTRY ) * in_nrOfKeys *
+                                                     MAX( nrOfRecords, U32( 1 )));
+
+        pool.pTask     = (sSORT_TASK*)::malloc( sizeof( sSORT_TASK ) * maxTasks );
+        pool.nrOfTasks = 0;
+        pool.nrOfBusy  = 0;
+
+        if (( pThread != NULL ) && ( pEntry != NULL ) && ( pool.pTask != NULL )) {
+            (void)::pthread_mutex_init( &pool.mutex, NULL );
+            (void)::pthread_cond_init( &pool.condition, NULL );
+
+            for ( ; keyId < ( in_firstKeyId + in_nrOfKeys ); keyId++ ) {
+                initSortTask( pHandle, keyId, ( pEntry + ( size_t( keyId - in_firstKeyId ) * nrOfRecords )),
+                              pool.pTask[ pool.nrOfTasks++ ] );
+            }
+
+            U32 nrOfStarted = 0;
+
+            for ( U32 i = 1; i < nrOfThreads; i++ ) {
+                if ( ::pthread_create( &pThread[ nrOfStarted ], NULL, sortWorker, &pool ) == 0 ) {
+                    nrOfStarted++;
+                }
+            }
+
+            (void)sortWorker( &pool );
+
+            for ( U32 i = 0; i < nrOfStarted; i++ ) {
+                (void)::pthread_join( pThread[ i ], NULL );
+            }
+
+            (void)::pthread_cond_destroy( &pool.condition );
+            (void)::pthread_mutex_destroy( &pool.mutex );
+
+            for ( U16 sortedId = in_firstKeyId; sortedId < keyId; sortedId++ ) {
+                const sKEY_ENTRY* pSorted = pEntry + ( size_t( sortedId - in_firstKeyId ) * nrOfRecords );
+
+                for ( U32 i = 0; i < nrOfRecords; i++ ) {
+                    pHandle->apKeyIndex[ sortedId ].apRecord[ i ] = pSorted[ i ].record;
+                }
+            }
+        }
+
+        ::free( pool.pTask );
+        ::free( pEntry );
+        ::free( pThread );
+    }
+#endif
+
+    // Sorted sequentially, single threaded or on a lack of memory.
+    for ( ; keyId < ( in_firstKeyId + in_nrOfKeys ); keyId++ ) {
+        sortKeyIndex( pHandle, keyId );
+    }
+
+    for ( keyId = in_firstKeyId; keyId < ( in_firstKeyId + in_nrOfKeys ); keyId++ ) {
+        pHandle->apKeyIndex[ keyId ].bSorted = true;
+        pHandle->apKeyIndex[ keyId ].stats.sorts++;
+        buildSortedKeys( pHandle, keyId, nrOfRecords );
+    }
+}
+
+/*============================================================================*/
+static void sortKeyIndex( OSNDXFIO::sHANDLE* const pHandle,
+                          U16 const                in_keyId )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex    = pHandle->apKeyIndex[ in_keyId ];
+    U32 const   nrOfRecords = pHandle->nrOfRecords;
+    sKEY_ENTRY* pEntry      = (sKEY_ENTRY*)::malloc( sizeof( sKEY_ENTRY ) * MAX( nrOfRecords, U32( 1 )));
+
+    /*--------------------------------------------------------------*/
+    /* Introsort: quicksort with a median of three pivot, heap sort */
+    /* if the recursion exceeds 2 * log2( n ) and insertion sort of */
+    /* small partitions. Keys are converted, memcmp() orders them.  */
+    /*--------------------------------------------------------------*/
+    if ( NULL != pEntry ) {
+        sSORT_TASK task;
+
+        initSortTask( pHandle, in_keyId, pEntry, task );
+        sortRange( task.context, task.pFirst, task.pLast, task.depthLimit );
+
+        for ( U32 i = 0; i < nrOfRecords; i++ ) {
+            keyIndex.apRecord[ i ] = pEntry[ i ].record;
+        }
+
+        ::free( pEntry );
+    } else {
+        // Without memory for the prefixes the records are sorted in place.
+        sSORT_CONTEXT context;
+
+        initSortContext( pHandle, in_keyId, context );
+        sortRange( context, keyIndex.apRecord, ( keyIndex.apRecord + nrOfRecords ),
+                   sortDepthLimit( nrOfRecords ));
+    }
+}
+
+/*============================================================================*/
+static void initSortTask( OSNDXFIO::sHANDLE* const pHandle,
+                          U16 const                in_keyId,
+                          sKEY_ENTRY*              pEntry,
+                          sSORT_TASK&              out_rTask )
+/*============================================================================*/
+{
+    sKEY_INDEX& keyIndex   = pHandle->apKeyIndex[ in_keyId ];
+    U32 const   prefixSize = MIN( U32( keyIndex.keySize ), U32( sizeof( pEntry->prefix )));
+
+    initSortContext( pHandle, in_keyId, out_rTask.context );
+    out_rTask.pFirst     = pEntry;
+    out_rTask.pLast      = pEntry + pHandle->nrOfRecords;
+    out_rTask.depthLimit = sortDepthLimit( pHandle->nrOfRecords );
+
+    // One pass over the keys, big endian prefixes compare like memcmp().
+    for ( U32 i = 0; i < pHandle->nrOfRecords; i++ ) {
+        const BYTE* pKey   = out_rTask.context.pKey +
+                             ( size_t( keyIndex.apRecord[ i ] ) * out_rTask.context.totalIndexSize );
+        U64         prefix = 0;
+
+        for ( U32 j = 0; j < sizeof( prefix ); j++ ) {
+            prefix = ( prefix << 8 ) | (( j < prefixSize ) ? pKey[ j ] : 0 );
+        }
+
+        pEntry[ i ].prefix = prefix;
+        pEntry[ i ].record = keyIndex.apRecord[ i ];
+    }
+}
+
+/*============================================================================*/
+static void initSortContext( const OSNDXFIO::sHANDLE* pHandle,
+                             U16                      in_keyId,
+                             sSORT_CONTEXT&           out_rContext )
+/*============================================================================*/
+{
+    const sKEY_INDEX& keyIndex = pHandle->apKeyIndex[ in_keyId ];
+
+    out_rContext.pKey           = pHandle->apKey + keyIndex.keyOffset;
+    out_rContext.totalIndexSize = pHandle->totalIndexSize;
+    out_rContext.keySize        = keyIndex.keySize;
+    out_rContext.pfCompare      = keyIndex.pfCompare;
+}
+
+/*============================================================================*/
+static U32 sortDepthLimit( U32 in_count )
+/*============================================================================*/
+{
+    U32 depthLimit = 0;
+
+    // 2 * log2( n ) partitions before sortRange() changes to heap sort.
+    for ( U32 n = in_count; n > 1; n >>= 1 ) {
+        depthLimit += 2;
+    }
+
+    return depthLimit;
+}
+
+/*============================================================================*/
+template <typename ELEMENT>
+static ELEMENT* partition( const sSORT_CONTEXT& context,
+                           ELEMENT*             pFirst,
+                           ELEMENT*             pLast )
+/*============================================================================*/
+{
+    // Order first, middle and last, the middle is the pivot.
+    ELEMENT* pMiddle = pFirst + (( pLast - pFirst ) / 2 );
+    ELEMENT* pBack   = pLast - 1;
+    ELEMENT  temp;
+
+    if ( isLess( context, *pMiddle, *pFirst )) {
+        temp = *pMiddle; *pMiddle = *pFirst; *pFirst = temp;
+    }
+
+    if ( isLess( context, *pBack, *pMiddle )) {
+        temp = *pBack; *pBack = *pMiddle; *pMiddle = temp;
+
+        if ( isLess( context, *pMiddle, *pFirst )) {
+            temp = *pMiddle; *pMiddle = *pFirst; *pFirst = temp;
+        }
+    }
+
+    // Hoare partition, first and last element stop the scans.
+    ELEMENT  pivot  = *pMiddle;
+    ELEMENT* pLeft  = pFirst;
+    ELEMENT* pRight = pBack;
+
+    for ( ;; ) {
+        do {
+            pLeft++;
+        } while ( isLess( context, *pLeft, pivot ));
+
+        do {
+            pRight--;
+        } while ( isLess( context, pivot, *pRight ));
+
+        if ( pLeft >= pRight ) {
+            break;
+        }
+
+        temp = *pLeft; *pLeft = *pRight; *pRight = temp;
+    }
+
+    return pRight + 1;
+}
+
+/*============================================================================*/
+template <typename ELEMENT>
+static void sortRange( const sSORT_CONTEXT& context,
+                       ELEMENT*             pFirst,
+                       ELEMENT*             pLast,
+                       U32                  depthLimit )
+/*============================================================================*/
+{
+    while (( pLast - pFirst ) > INSERTION_SORT ) {
+        if ( depthLimit == 0 ) {
+            heapSort( context, pFirst, U32( pLast - pFirst ));
+            return;
+        }
+
+        depthLimit--;
+
+        // Recursion on the smaller part limits the stack depth.
+        ELEMENT* pSplit = partition( context, pFirst, pLast );
+
+        if (( pSplit - pFirst ) < ( pLast - pSplit )) {
+            sortRange( context, pFirst, pSplit, depthLimit );
+            pFirst = pSplit;
+        } else {
+            sortRange( context, pSplit, pLast, depthLimit );
+            pLast = pSplit;
+        }
+    }
+
+    insertionSort( context, pFirst, pLast );
+}
+
+/*============================================================================*/
+template <typename ELEMENT>
+static void heapSort( const sSORT_CONTEXT& context,
+                      ELEMENT*             pBase,
+                      U32                  count )
+/*============================================================================*/
+{
+    // Build the heap, then move the largest element to the end.
+    for ( U32 start = count / 2; start > 0; start-- ) {
+        siftDown( context, pBase, ( start - 1 ), count );
+    }
+
+    for ( U32 end = count - 1; end > 0; end-- ) {
+        ELEMENT temp = pBase[ 0 ];
+        pBase[ 0 ]   = pBase[ end ];
+        pBase[ end ] = temp;
+        siftDown( context, pBase, 0, end );
+    }
+}
+
+/*============================================================================*/
+template <typename ELEMENT>
+static void siftDown( const sSORT_CONTEXT& context,
+                      ELEMENT*             pBase,
+                      U32                  root,
+                      U32                  count )
+/*============================================================================*/
+{
+    ELEMENT entry = pBase[ root ];
+
+    for ( U32 child = ( 2 * root ) + 1; child < count; child = ( 2 * root ) + 1 ) {
+        if ((( child + 1 ) < count ) && isLess( context, pBase[ child ], pBase[ child + 1 ] )) {
+            child++;
+        }
+
+        if ( !isLess( context, entry, pBase[ child ] )) {
+            break;
+        }
+
+        pBase[ root ] = pBase[ child ];
+        root          = child;
+    }
+
+    pBase[ root ] = entry;
+}
+
+/*============================================================================*/
+template <typename ELEMENT>
+static void insertionSort( const sSORT_CONTEXT& context,
+                           ELEMENT*             pFirst,
+                           ELEMENT*             pLast )
+/*============================================================================*/
+{
+    for ( ELEMENT* pNext = pFirst + 1; pNext < pLast; pNext++ ) {
+        ELEMENT  entry = *pNext;
+        ELEMENT* pHole = pNext;
+
+        while (( pHole > pFirst ) && isLess( context, entry, *( pHole - 1 ))) {
+            *pHole = *( pHole - 1 );
+            pHole--;
+        }
+
+        *pHole = entry;
+    }
 }
 
 /*============================================================================*/
@@ -45,6 +45,12 @@
 // ---- include files ----
 #include <osdef.h>
 
+// ---- symbol definitions ----
+#define SORT_ORDER_EXTENSION ".srt" // Side file of the sorted key indices, see sOPTIONS.
+
+// ---- forward declarations ----
+struct sIO_STATS; // I/O statistics, see osfio.hpp.
+
 class OSNDXFIO {
 public:
 // Error codes.
@@ -65,10 +71,12 @@ enum eERROR {
     NO_DATABASE,
     NO_ERROR,
     NO_RECORD,
+    NOT_MAPPED,
     RECORD_TOO_LARGE,
     RECORD_TOO_SMALL,
     SIZE_MISMATCH,
     TOO_MANY_RECORDS,
+    UPGRADE_REQUIRED
 };
 
 /** Type definitions used for building index keys. Do not modify or erase
@@ -206,6 +214,70 @@ struct sRECORD {
     }
 };
 
+/** Durability of changes, see sOPTIONS. A synchronization commits all
+    changes since the previous one with one fdatasync. */
+enum eDURABILITY {
+    DURABILITY_NONE,     // Left to the operating system, commit() only.
+    DURABILITY_CLOSE,    // Synchronized by commit() and close().
+    DURABILITY_PERIODIC, // Also after a change syncInterval seconds after
+                         // the previous synchronization.
+    DURABILITY_GROUP     // Also after groupSize changes (group commit).
+};
+
+/** Optional settings of an opened database, see open(). */
+struct sOPTIONS {
+    U32  cacheSize; // Memory budget in bytes of the block cache serving data
+                    // record reads. Default 0, no cache.
+    bool directIO;  // Bypass the page cache of the operating system (Linux
+                    // O_DIRECT), if supported. Default false.
+    eDURABILITY durability;
+                    // Synchronization of changes. Default DURABILITY_NONE.
+    U32  syncInterval; // Seconds, see DURABILITY_PERIODIC. Default 1.
+    U32  groupSize; // Changes, see DURABILITY_GROUP. Default 0, batched
+                    // writers call commit().
+    U32  sortThreads; // Threads sorting the key indices (Linux). Default 1,
+                    // sorted by the calling thread.
+    bool saveSortOrder; // close() saves the sorted key indices in a side
+                    // file, the database name + SORT_ORDER_EXTENSION. open()
+                    // loads them instead of sorting. Default false.
+    bool keyArrays; // Keeps the keys of every key index contiguous in sorted
+                    // order, existRecord() searches them without reading
+                    // the index records. Costs the key size per record and
+                    // key. Default false.
+    bool searchLayout; // Read-only databases: open() rebuilds the search
+                    // structure of every key index in Eytzinger (breadth
+                    // first) order, existRecord() prefetches the next tree
+                    // levels. Costs the key size + 4 bytes per record and
+                    // key. Default false.
+
+    sOPTIONS() // Constructor.
+        :
+        cacheSize( 0 ),
+        directIO( false ),
+        durability( DURABILITY_NONE ),
+        syncInterval( 1 ),
+        groupSize( 0 ),
+        sortThreads( 1 ),
+        saveSortOrder( false ),
+        keyArrays( false ),
+        searchLayout( false ) {
+    }
+};
+
+/** Maintenance of a key index since open(), see getKeyStats(). */
+struct sKEY_STATS {
+    U64 appends; // New keys at or above the greatest key, appended.
+    U64 inserts; // New or changed keys inserted at a searched position.
+    U64 sorts;   // Sorts of the whole key index.
+
+    sKEY_STATS() // Constructor.
+        :
+        appends( 0 ),
+        inserts( 0 ),
+        sorts( 0 ) {
+    }
+};
+
 OSNDXFIO();  // Constructor.
 ~OSNDXFIO(); // Destructor.
 
@@ -214,28 +286,38 @@ OSNDXFIO();  // Constructor.
 /**
 *  Opens an existing database.
 *
-*  @param  in_databaseName   File name of the database.
-*  @param  in_readOnly       Flag to indicate readonly access.
+*  @param  in_databaseName   File name of the database. A name beginning
+*                            with STORAGE_PREFIX is a database in memory,
+*                            see OSFIO::mount().
+*  @param  in_readOnly       Flag to indicate readonly access. A read only
+*                            database is mapped into memory if supported,
+*                            see getRecordView().
 *  @param  in_allocatedIndexKeys
 *                            Number of index keys to be allocated in memory (in
                              advance).
+*  @param  in_options        Optional settings, see sOPTIONS.
 *  @return True if successful. On false error could be retrieved with
-*          getLastError().
+*          getLastError(). UPGRADE_REQUIRED if a database of an older file
+*          format version is not opened read only, see upgrade().
 *  @post   OSNDXFIO operations can be performed on the database if successful.
 */
-bool open( const STRING in_databaseName,
-           bool         in_readOnly = false,
-           U32          in_allocatedIndexKeys = DEFAULT_ALLOCATED_INDEX_KEYS );
+bool open( const STRING    in_databaseName,
+           bool            in_readOnly = false,
+           U32             in_allocatedIndexKeys = DEFAULT_ALLOCATED_INDEX_KEYS,
+           const sOPTIONS& in_options = sOPTIONS() );
 
 /**
 *  Creates and opens a new indexed database.
 *
-*  @param  in_databaseName   File name of the database.
+*  @param  in_databaseName   File name of the database. A name beginning
+*                            with STORAGE_PREFIX creates a database in
+*                            memory, it is released by OSFIO::erase().
 *  @param  in_nrOfKeys       Number of index keys.
 *  @param  in_keyDescriptor  Description (array) of every index key.
 *  @param  in_reservedIndexRecords
 *                            Number of index record to be reserved (in case
 *                            of creation of records).
+*  @param  in_options        Optional settings, see sOPTIONS.
 *  @return True if successful. On false error could be retrieved with
 *          getLastError().
 *  @post   OSNDXFIO operations can be performed on the created database.
@@ -243,7 +325,8 @@ bool open( const STRING in_databaseName,
 bool create( const STRING    in_databaseName,
              U16             in_nrOfKeys,
              const sKEY_DESC in_keyDescriptor[],
-             U16             in_reservedIndexRecords = DEFAULT_RESERVED_INDEX_RECORDS );
+             U16             in_reservedIndexRecords = DEFAULT_RESERVED_INDEX_RECORDS,
+             const sOPTIONS& in_options = sOPTIONS() );
 
 /**
 *  Closes a previously opened indexed database. The indexed database is also
@@ -261,6 +344,9 @@ bool close();
 *  Warning: Take care if the existing key index is based on data before the
 *  data offset.
 *
+*  The rebuild database is created with the options of this database, see
+*  sOPTIONS.
+*
 *  @pre    Opened indexed database.
 *  @param  in_databaseName   File name of the rebuild database.
 *  @param  in_nrOfKeys       Number of index keys.
@@ -274,6 +360,89 @@ bool rebuild( const STRING    in_databaseName,
               const sKEY_DESC in_keyDescriptor[],
               U32             in_maxDataSize = MAXIMUM_DATA_SIZE );
 
+/**
+*  Converts an opened database of an older file format version into a new
+*  database of the current version, with the same key descriptor. Databases
+*  of an older version can only be opened read only.
+*
+*  @pre    Opened indexed database (read only).
+*  @param  in_databaseName   File name of the upgraded database.
+*  @param  in_maxDataSize    Mazimum expected data size (for memory allocation).
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool upgrade( const STRING in_databaseName,
+              U32          in_maxDataSize = MAXIMUM_DATA_SIZE );
+
+/**
+*  Commits the changes of the open database to the storage device. All
+*  changes since the previous synchronization share one fdatasync, batched
+*  or serialized concurrent writers call commit() once per batch, see
+*  sOPTIONS::durability.
+*
+*  @pre    Opened indexed database.
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool commit();
+
+/**
+*  Retrieves the block cache statistics of the open database, see
+*  sOPTIONS::cacheSize.
+*
+*  @param  out_rHits     Number of block reads served by the cache.
+*  @param  out_rMisses   Number of block reads from the file.
+*  @return True if the block cache is enabled.
+*/
+bool getCacheStats( U64& out_rHits,
+                    U64& out_rMisses );
+
+/**
+*  Retrieves the I/O statistics of the open database since open() or
+*  resetIOStats(), see sIO_STATS. Together with the elapsed time it tells
+*  CPU cost from I/O cost.
+*
+*  @param  out_rStats    The statistics.
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool getIOStats( sIO_STATS& out_rStats );
+
+/**
+*  Resets the I/O statistics of the open database, see getIOStats().
+*
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool resetIOStats();
+
+/**
+*  Retrieves the maintenance statistics of a key index of the open
+*  database, see sKEY_STATS. Keys of ascending values, such as time stamps
+*  or sequence numbers, are appended without search.
+*
+*  @param  in_keyId      The key index (0 - (numberOfKeys - 1)).
+*  @param  out_rStats    The statistics.
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool getKeyStats( U16         in_keyId,
+                  sKEY_STATS& out_rStats );
+
+/**
+*  Sets the growth policy of the open database. When a record or index
+*  block is written beyond the preallocated end of the file, the file is
+*  preallocated (Linux fallocate) in steps of in_growthSize bytes instead of
+*  growing every record. The preallocated end is saved in the file header.
+*
+*  @pre    Opened indexed database (read/write).
+*  @param  in_growthSize Number of bytes to preallocate, e.g. 64 MB. Default
+*                        0, no preallocation.
+*  @return True if successful. On false error could be retrieved with
+*          getLastError().
+*/
+bool setGrowth( U32 in_growthSize );
+
 /** Returns number of keys of open database. */
 U16 getNrOfKeys();
 
@@ -341,6 +510,39 @@ bool getRecord( sKEY&    in_rKey,
 bool getRecord( U32      in_index,
                 sRECORD& out_rRecord );
 
+/**
+*  Retrieves a pointer to an index based data record in the memory mapped
+*  database. No system call is made and no data is copied.
+*
+*  @pre    Database opened read only and mapped.
+*  @param  in_index      Index identification of specific record.
+*  @param  out_rpData    Pointer to the data record in the mapping. Valid
+*                        until the database is closed.
+*  @param  out_rDataSize Actual size of the data record.
+*  @return True if successful. On false error could be retrieved with
+*          getLastError(). NOT_MAPPED if the database is not mapped, use
+*          getRecord() instead.
+*/
+bool getRecordView( U32          in_index,
+                    const BYTE*& out_rpData,
+                    U32&         out_rDataSize );
+
+/**
+*  Retrieves multiple index based data records. All reads are submitted
+*  together, on Linux asynchronously by io_uring.
+*
+*  @param  in_count      Number of records.
+*  @param  in_pIndex     Array of in_count index identifications.
+*  @param  out_pRecord   Array of in_count data records what include
+*                        pointers to actual data. Struct field dataSize
+*                        returns actual size.
+*  @return True if all records are retrieved. On false error could be
+*          retrieved with getLastError().
+*/
+bool getRecords( U32           in_count,
+                 const U32*    in_pIndex,
+                 sRECORD*      out_pRecord );
+
 /**
 *  Retrieves the next data record after getRecord() based on search key.
 *
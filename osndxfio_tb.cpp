@@ -24,7 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#include <sys\timeb.h>
+#include <sys/timeb.h>
 
 // ---- include files ----
 #include <osdef.h>
@@ -75,7 +75,11 @@ static OSNDXFIO::sKEY_SEGMENT key3[ 2 ] = {
     OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU32, sizeof( U32 ))
 };
 
-static STRING database1 = "testDb1.dat";
+static char database1[] = "testDb1.dat";
+static char database2[] = "testDb2.dat";
+static char database3[] = "testDb3.dat";
+static char database4[] = "testDb4.dat";
+static char database5[] = STORAGE_PREFIX "testDb5.dat";
 
 static U32 passedCounter = 0;
 static U32 failedCounter = 0;
@@ -119,17 +123,20 @@ void printDescription( U16 testNumber, const STRING description )
 void getNextObject( sTEST_OBJECT& object )
 /*============================================================================*/
 {
-    ::memset( &object, 0, sizeof( object ));
+    object = sTEST_OBJECT();
+    char buffer[ 32 ];
 
     object.id = ::rand() % MAX_NB_IDS;
     generatedIds[ object.id ]++;
 
     int randomName = ::rand() % MAX_NB_NAMES;
-    ::sprintf( object.name, "MY-NAME-%02d", randomName );
+    ::sprintf( buffer, "MY-NAME-%02d", randomName );
+    ::memcpy( object.name, buffer, SIZE_OF_NAME );
     generatedNames[ randomName ]++;
 
     int randomDepartment = ::rand() % MAX_NB_DEPARTMENTS;
-    ::sprintf( object.department, "MY_DEPARTMENT-%d", randomDepartment );
+    ::sprintf( buffer, "MY_DEPARTMENT-%d", randomDepartment );
+    ::memcpy( object.department, buffer, SIZE_OF_DEPARTMENT );
     generatedDepartments[ randomDepartment ]++;
 }
 
@@ -155,7 +162,7 @@ bool test1( void )
     keyDesc[ 1 ].nrOfSegments = NR_ELEMENTS( ::key2 );
     keyDesc[ 1 ].apSegment    = ::key2;
     keyDesc[ 2 ].nrOfSegments = NR_ELEMENTS( ::key3 );
-    keyDesc[ 2 ].apSegment    = ::key2;
+    keyDesc[ 2 ].apSegment    = ::key3;
 
     (void)OSFIO::erase( database1 ); // If exist, erase test database.
 
@@ -197,7 +204,9 @@ bool test2( void )
     bool statusOk = testDb.open( database1 );
 
     // Clear testObject array;
-    ::memset( testObjects, 0, sizeof( testObjects ));
+    for ( U16 i = 0; i < maxRecords; i++ ) {
+        testObjects[ i ] = sTEST_OBJECT();
+    }
     // Create maxRecords records.
     for ( U16 i = 0; ( statusOk && ( i < maxRecords )); i++ ) {
         sTEST_OBJECT testObject;
@@ -236,7 +245,7 @@ bool test3( void )
     // Read all records and compare.
     for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
         testRecord.dataSize = 0;
-        ::memset( &testObject, INVALID_VALUE, sizeof( testObject ));
+        ::memset( (void*)&testObject, INVALID_VALUE, sizeof( testObject ));
         statusOk = testDb.getRecord( i, testRecord );
         statusOk = statusOk && ( U32( sizeof( sTEST_OBJECT )) == testRecord.dataSize );
         // Compare with testObject array.
@@ -329,6 +338,1457 @@ bool test4( void )
     return statusOk;
 }
 
+/**
+ *  Test open and upgrade of a version 1 (32-bit offsets) database. The version
+ *  1 file is written as OSNDXFIO 1.0.0 did.
+ *
+ *  @return  True if successful.
+ */
+bool test5( void )
+/*============================================================================*/
+{
+    printDescription( 5, "Open and upgrade version 1 database" );
+
+    struct sDATA_V1 { S32 id; U32 recordRef; U32 size; U32 offset; };
+    struct sINDEX_V1 { S32 status; U32 offset; U32 dataOffset; U32 dataSize; U32 recordRef; };
+    struct sHEADER_V1 {
+        U32 version, recordReference, nextFreeData, nrOfRecords, nrOfIndexRecords;
+        S32 lastDeletedIndex;
+        U32 nextFreeIndex;
+        U16 reservedIndexRecords, nrOfKeys, totalKeySize, keyDescriptorSize;
+    };
+
+    U16 const nrOfRecords  = 3;
+    U16 const reserved     = 10;
+    U32 const indexSize    = sizeof( sINDEX_V1 ) + sizeof( U32 );
+    U32 const keyDescSize  = sizeof( U16 ) + sizeof( OSNDXFIO::sKEY_SEGMENT );
+    U32 const indexStart   = sizeof( sDATA_V1 ) + sizeof( sHEADER_V1 ) + keyDescSize;
+    U32 const dataStart    = indexStart + sizeof( sDATA_V1 ) + ( reserved * indexSize ) +
+                             sizeof( sDATA_V1 );
+    U32 const recordSize   = sizeof( sDATA_V1 ) + sizeof( sTEST_OBJECT );
+
+    sDATA_V1   data   = { -4 /* eHEADER */, 0, sizeof( sHEADER_V1 ) + keyDescSize, indexStart };
+    sHEADER_V1 header = { 0x01000000, nrOfRecords, dataStart + ( nrOfRecords * recordSize ),
+                          nrOfRecords, reserved, -1,
+                          indexStart + sizeof( sDATA_V1 ) + ( nrOfRecords * indexSize ),
+                          reserved, 1, sizeof( U32 ), U16( keyDescSize ) };
+    U16 nrOfSegments = NR_ELEMENTS( ::key2 );
+
+    (void)OSFIO::erase( database2 );
+    (void)OSFIO::erase( database3 );
+
+    OSFIO file;
+    bool statusOk = file.create( database2 );
+    statusOk = statusOk && file.close();
+    statusOk = statusOk && file.open( database2 );
+    statusOk = statusOk && file.write( &data, sizeof( data ));
+    statusOk = statusOk && file.write( &header, sizeof( header ));
+    statusOk = statusOk && file.write( &nrOfSegments, sizeof( nrOfSegments ));
+    statusOk = statusOk && file.write( ::key2, sizeof( ::key2 ));
+
+    data.id     = -3; // eINDEX
+    data.size   = reserved * indexSize;
+    data.offset = indexStart + sizeof( data ) + data.size;
+    statusOk = statusOk && file.write( &data, sizeof( data ));
+
+    for ( U16 i = 0; statusOk && ( i < reserved ); i++ ) {
+        sINDEX_V1 index = { -2 /* eRESERVED */, U32( indexStart + sizeof( data ) + ( i * indexSize )),
+                            U32( INVALID_VALUE ), 0, 0 };
+        BYTE key[ sizeof( U32 ) ] = { 0, 0, 0, 0 };
+
+        if ( i < nrOfRecords ) {
+            index.status     = -1; // eOK
+            index.dataOffset = dataStart + ( i * recordSize );
+            index.dataSize   = sizeof( sTEST_OBJECT );
+            index.recordRef  = i;
+            key[ 3 ]         = BYTE( testObjects[ i ].id );      // Converted key,
+            key[ 2 ]         = BYTE( testObjects[ i ].id >> 8 ); // big endian.
+        }
+
+        statusOk = statusOk && file.write( &index, sizeof( index ));
+        statusOk = statusOk && file.write( key, sizeof( key ));
+    }
+
+    data.id     = -2; // eNEXT_INDEX
+    data.size   = 0;
+    data.offset = 0;
+    statusOk = statusOk && file.write( &data, sizeof( data ));
+
+    for ( U16 i = 0; statusOk && ( i < nrOfRecords ); i++ ) {
+        data.id        = 0; // eDATA
+        data.recordRef = i;
+        data.size      = sizeof( sTEST_OBJECT );
+        data.offset    = dataStart + (( i + 1 ) * recordSize );
+        statusOk = statusOk && file.write( &data, sizeof( data ));
+        statusOk = statusOk && file.write( &testObjects[ i ], sizeof( sTEST_OBJECT ));
+    }
+
+    (void)file.close();
+
+    OSNDXFIO testDb;
+    // Version 1 databases are read only.
+    statusOk = statusOk && !testDb.open( database2 ); // Fails!
+    statusOk = statusOk && ( testDb.getLastError() == OSNDXFIO::UPGRADE_REQUIRED );
+    statusOk = statusOk && testDb.open( database2, READ_ONLY_ACCESS );
+    statusOk = statusOk && ( testDb.getNrOfRecords() == nrOfRecords );
+    statusOk = statusOk && testDb.upgrade( database3 );
+    (void)testDb.close();
+
+    // Check all records of the upgraded database, read and write.
+    statusOk = statusOk && testDb.open( database3 );
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+
+    for ( U16 i = 0; statusOk && ( i < nrOfRecords ); i++ ) {
+        U32 searchId = testObjects[ i ].id;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        U32 index = INVALID_VALUE;
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && testDb.getRecord( index, testRecord );
+        statusOk = statusOk && ( testObject.id == testObjects[ i ].id );
+    }
+
+    statusOk = statusOk && ( testDb.getNrOfRecords() == nrOfRecords );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test zero-copy record views of a read only database.
+ *
+ *  @return  True if successful.
+ */
+bool test6( void )
+/*============================================================================*/
+{
+    printDescription( 6, "Zero-copy record view of read only database" );
+
+    OSNDXFIO testDb;
+    const BYTE* pData = NULL;
+    U32 dataSize = 0;
+    // Read write databases are not mapped.
+    bool statusOk = testDb.open( database1 );
+    statusOk = statusOk && !testDb.getRecordView( 0, pData, dataSize ); // Fails!
+    statusOk = statusOk && ( testDb.getLastError() == OSNDXFIO::NOT_MAPPED );
+    statusOk = statusOk && testDb.close();
+
+    statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS );
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        statusOk = testDb.getRecordView( i, pData, dataSize );
+        statusOk = statusOk && ( U32( sizeof( sTEST_OBJECT )) == dataSize );
+        // Compare with testObject array.
+        statusOk = statusOk && ( ::memcmp( pData, &testObjects[ i ], sizeof( sTEST_OBJECT )) == 0 );
+    }
+
+    statusOk = statusOk && !testDb.getRecordView( testDb.getNrOfRecords(), pData, dataSize );
+    statusOk = statusOk && ( testDb.getLastError() == OSNDXFIO::ENTRY_NOT_FOUND );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test updating records.
+ *
+ *  @return  True if successful.
+ */
+bool test7( void )
+/*============================================================================*/
+{
+    printDescription( 7, "Update records" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    U32 const nbUpdates = 100;
+
+    bool statusOk = testDb.open( database1 );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbUpdates )); i++ ) {
+        testObjects[ i ].data[ 0 ] = BYTE( i + 1 );
+        testObjects[ i ].id        = MAX_NB_IDS + i; // Key change.
+        ::memcpy( &testObject, &testObjects[ i ], sizeof( testObject )); // Including padding.
+        statusOk = testDb.updateRecord( i, testRecord );
+    }
+
+    // Verify the updated records, before and after reopening the database.
+    for ( U16 pass = 0; ( statusOk && ( pass < 2 )); pass++ ) {
+        for ( U32 i = 0; ( statusOk && ( i < nbUpdates )); i++ ) {
+            ::memset( (void*)&testObject, INVALID_VALUE, sizeof( testObject ));
+            statusOk = testDb.getRecord( i, testRecord );
+            statusOk = statusOk && ( U32( sizeof( sTEST_OBJECT )) == testRecord.dataSize );
+            statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+        }
+
+        statusOk = statusOk && testDb.close();
+        statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS );
+    }
+
+    statusOk = statusOk && ( testDb.getNrOfRecords() == maxRecords );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test retrieving multiple records.
+ *
+ *  @return  True if successful.
+ */
+bool test8( void )
+/*============================================================================*/
+{
+    printDescription( 8, "Retrieving multiple records" );
+
+    U32 const nbRecords = 500;
+    sTEST_OBJECT* pObjects = new sTEST_OBJECT[ nbRecords ];
+    OSNDXFIO::sRECORD* pRecords = (OSNDXFIO::sRECORD*)::malloc( nbRecords * sizeof( OSNDXFIO::sRECORD ));
+    U32 aIndex[ nbRecords ];
+
+    for ( U32 i = 0; i < nbRecords; i++ ) {
+        aIndex[ i ] = ( i * 7 ) % maxRecords; // Not in file order.
+        pRecords[ i ] = OSNDXFIO::sRECORD( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&pObjects[ i ] );
+    }
+
+    OSNDXFIO testDb;
+    bool statusOk = testDb.open( database1 );
+
+    // Read write and read only (mapped) database.
+    for ( U16 pass = 0; ( statusOk && ( pass < 2 )); pass++ ) {
+        statusOk = testDb.getRecords( nbRecords, aIndex, pRecords );
+
+        for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+            statusOk = ( U32( sizeof( sTEST_OBJECT )) == pRecords[ i ].dataSize );
+            statusOk = statusOk && ( ::memcmp( &pObjects[ i ], &testObjects[ aIndex[ i ]], sizeof( sTEST_OBJECT )) == 0 );
+        }
+
+        statusOk = statusOk && testDb.close();
+        statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS );
+    }
+
+    aIndex[ 0 ] = testDb.getNrOfRecords();
+    statusOk = statusOk && !testDb.getRecords( nbRecords, aIndex, pRecords );
+    statusOk = statusOk && ( testDb.getLastError() == OSNDXFIO::ENTRY_NOT_FOUND );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    ::free( pRecords );
+    delete[] pObjects;
+
+    return statusOk;
+}
+
+/**
+ *  Test reading records through the block cache.
+ *
+ *  @return  True if successful.
+ */
+bool test9( void )
+/*============================================================================*/
+{
+    printDescription( 9, "Read records through the block cache" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sOPTIONS options;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+    U64 hits   = 0;
+    U64 misses = 0;
+
+    // No cache by default.
+    bool statusOk = testDb.open( database1 );
+    statusOk = statusOk && !testDb.getCacheStats( hits, misses );
+    statusOk = statusOk && testDb.close();
+
+    options.cacheSize = 1 << 20;
+    statusOk = statusOk && testDb.open( database1, READ_WRITE_ACCESS,
+                                        OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+
+    // Read all records twice, the second time from the cache.
+    for ( U16 pass = 0; ( statusOk && ( pass < 2 )); pass++ ) {
+        for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+            statusOk = testDb.getRecord( i, testRecord );
+            statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+        }
+
+        statusOk = statusOk && testDb.getCacheStats( hits, misses );
+        statusOk = statusOk && ( hits > ( pass * 2 * testDb.getNrOfRecords() ));
+    }
+
+    // Updated records are not read from stale cache blocks.
+    testObjects[ 0 ].data[ 1 ]++;
+    ::memcpy( &testObject, &testObjects[ 0 ], sizeof( testObject ));
+    testRecord.dataSize = sizeof( testObject );
+    statusOk = statusOk && testDb.updateRecord( 0, testRecord );
+    testObject = sTEST_OBJECT();
+    statusOk = statusOk && testDb.getRecord( 0, testRecord );
+    statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ 0 ], sizeof( testObject )) == 0 );
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test rebuilding a database with direct I/O.
+ *
+ *  @return  True if successful.
+ */
+bool test10( void )
+/*============================================================================*/
+{
+    printDescription( 10, "Rebuild database with direct I/O" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sOPTIONS options;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+
+    (void)OSFIO::erase( database4 );
+
+    options.directIO = true;
+    bool statusOk = testDb.open( database1, READ_WRITE_ACCESS,
+                                 OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+    statusOk = statusOk && testDb.rebuild( database4, NR_ELEMENTS( keyDesc ), keyDesc,
+                                           sizeof( sTEST_OBJECT ));
+    statusOk = statusOk && testDb.close();
+    statusOk = statusOk && testDb.open( database4, READ_WRITE_ACCESS,
+                                        OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+    statusOk = statusOk && ( testDb.getNrOfRecords() == maxRecords );
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+        statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database4 );
+
+    return statusOk;
+}
+
+/**
+ *  Test preallocation of the database file.
+ *
+ *  @return  True if successful.
+ */
+bool test11( void )
+/*============================================================================*/
+{
+    printDescription( 11, "Preallocate database file" );
+
+    OSNDXFIO testDb;
+    OSFIO file;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    U32 const growthSize = 1 << 20;
+    U32 const nbRecords  = 1000;
+    U64 fileSize         = 0;
+    U32 index            = 0;
+
+    (void)OSFIO::erase( database4 );
+
+    bool statusOk = testDb.create( database4, NR_ELEMENTS( keyDesc ), keyDesc );
+    statusOk = statusOk && testDb.setGrowth( growthSize );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        ::memcpy( &testObject, &testObjects[ i ], sizeof( testObject ));
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.close();
+
+    // Preallocated if supported, the file size is not the logical size.
+    statusOk = statusOk && file.open( database4, READ_ONLY_ACCESS );
+    statusOk = statusOk && (( fileSize = file.size() ) != (U64)INVALID_VALUE );
+    statusOk = statusOk && file.close();
+
+    // The preallocated end is saved, the file does not grow.
+    statusOk = statusOk && testDb.open( database4 );
+    statusOk = statusOk && testDb.setGrowth( growthSize );
+    statusOk = statusOk && testDb.createRecord( testRecord, index );
+    statusOk = statusOk && testDb.close();
+    statusOk = statusOk && file.open( database4, READ_ONLY_ACCESS );
+    statusOk = statusOk && (( fileSize < growthSize ) || ( file.size() == fileSize ));
+    statusOk = statusOk && file.close();
+
+    statusOk = statusOk && testDb.open( database4, READ_ONLY_ACCESS );
+    statusOk = statusOk && !testDb.setGrowth( growthSize ); // Fails, read only!
+    statusOk = statusOk && ( testDb.getNrOfRecords() == ( nbRecords + 1 ));
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+        statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database4 );
+
+    return statusOk;
+}
+
+/**
+ *  Test a database in memory.
+ *
+ *  @return  True if successful.
+ */
+bool test12( void )
+/*============================================================================*/
+{
+    printDescription( 12, "Rebuild database in memory" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    const BYTE* pData = NULL;
+    U32 dataSize      = 0;
+
+    bool statusOk = !testDb.open( database5 ); // Fails, not created!
+    statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS );
+    statusOk = statusOk && testDb.rebuild( database5, NR_ELEMENTS( keyDesc ), keyDesc,
+                                           sizeof( sTEST_OBJECT ));
+    statusOk = statusOk && testDb.close();
+
+    // The memory database persists after close, it is viewed read only.
+    statusOk = statusOk && testDb.open( database5, READ_ONLY_ACCESS );
+    statusOk = statusOk && ( testDb.getNrOfRecords() == maxRecords );
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+        statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+        statusOk = statusOk && testDb.getRecordView( i, pData, dataSize );
+        statusOk = statusOk && ( ::memcmp( pData, &testObjects[ i ], sizeof( testObject )) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    statusOk = statusOk && OSFIO::erase( database5 );
+    statusOk = statusOk && !testDb.open( database5 ); // Fails, erased!
+
+    return statusOk;
+}
+
+/**
+ *  Test the I/O statistics.
+ *
+ *  @return  True if successful.
+ */
+bool test13( void )
+/*============================================================================*/
+{
+    printDescription( 13, "I/O statistics of record reads" );
+
+    OSNDXFIO testDb;
+    sIO_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+    U32 const nbReads = 100;
+
+    bool statusOk = !testDb.getIOStats( stats ); // Fails, not opened!
+    statusOk = statusOk && testDb.open( database1 );
+    statusOk = statusOk && testDb.resetIOStats();
+
+    for ( U32 i = 0; ( statusOk && ( i < nbReads )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+    }
+
+    // Data header and data of every record are read.
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.reads == ( 2 * nbReads )) && ( stats.writes == 0 );
+    statusOk = statusOk && ( stats.bytesRead > ( nbReads * sizeof( sTEST_OBJECT )));
+    statusOk = statusOk && testDb.close();
+
+    // Mapped databases are read without transfers.
+    statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS );
+    statusOk = statusOk && testDb.resetIOStats();
+
+    for ( U32 i = 0; ( statusOk && ( i < nbReads )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+    }
+
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.reads == 0 );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test group commit of changes.
+ *
+ *  @return  True if successful.
+ */
+bool test14( void )
+/*============================================================================*/
+{
+    printDescription( 14, "Group commit of created records" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sOPTIONS options;
+    sIO_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    U32 const groupSize = 10;
+    U32 const nbRecords = 25;
+    U64 otherCalls      = 0;
+    U32 index           = 0;
+
+    (void)OSFIO::erase( database4 );
+
+    options.durability = OSNDXFIO::DURABILITY_GROUP;
+    options.groupSize  = groupSize;
+    bool statusOk = !testDb.commit(); // Fails, not opened!
+    statusOk = statusOk && testDb.create( database4, NR_ELEMENTS( keyDesc ), keyDesc,
+                                          OSNDXFIO::DEFAULT_RESERVED_INDEX_RECORDS, options );
+
+    // Every group of records is synchronized once.
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        ::memcpy( &testObject, &testObjects[ i ], sizeof( testObject ));
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.getIOStats( stats );
+    otherCalls = stats.otherCalls;
+    statusOk = statusOk && testDb.commit();
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.otherCalls == ( otherCalls + 1 ));
+
+    // Nothing to commit.
+    statusOk = statusOk && testDb.commit();
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.otherCalls == ( otherCalls + 1 ));
+    statusOk = statusOk && testDb.close();
+
+    statusOk = statusOk && testDb.open( database4, READ_ONLY_ACCESS );
+    statusOk = statusOk && ( testDb.getNrOfRecords() == nbRecords );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database4 );
+
+    return statusOk;
+}
+
+/**
+ *  Test access pattern hints of scans and lookups.
+ *
+ *  @return  True if successful.
+ */
+bool test15( void )
+/*============================================================================*/
+{
+    printDescription( 15, "Access pattern of scans and lookups" );
+
+    OSNDXFIO testDb;
+    sIO_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+    U32 const nbReads = 100;
+
+    bool statusOk = testDb.open( database1 );
+    statusOk = statusOk && testDb.resetIOStats();
+
+    // A scan is announced once.
+    for ( U32 i = 0; ( statusOk && ( i < nbReads )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+    }
+
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.otherCalls == 1 );
+
+    // Lookups end the scan.
+    statusOk = statusOk && testDb.getRecord( 10, testRecord );
+    statusOk = statusOk && testDb.getRecord( nbReads, testRecord );
+    statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ nbReads ], sizeof( testObject )) == 0 );
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.otherCalls == 2 );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test block reads of the index by open().
+ *
+ *  @return  True if successful.
+ */
+bool test16( void )
+/*============================================================================*/
+{
+    printDescription( 16, "Read index blocks on open" );
+
+    OSNDXFIO testDb;
+    sIO_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, 0, (BYTE*)&testObject );
+
+    // Every block of reserved index records is read at once.
+    bool statusOk = testDb.open( database1 );
+    statusOk = statusOk && testDb.getIOStats( stats );
+    statusOk = statusOk && ( stats.reads < ( testDb.getNrOfRecords() / 10 ));
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+        statusOk = statusOk && ( ::memcmp( &testObject, &testObjects[ i ], sizeof( testObject )) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test the key index sort of descending keys with duplicates.
+ *
+ *  @return  True if successful.
+ */
+bool test17( void )
+/*============================================================================*/
+{
+    printDescription( 17, "Sort descending and duplicate keys" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    U32 const nbRecords    = 3000;
+    U32 const nbDuplicates = 3;
+    U32 index              = INVALID_VALUE;
+
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = ( nbRecords - 1 - i ) / nbDuplicates;
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.close();
+
+    // The index is sorted on open, equal keys in record order.
+    statusOk = statusOk && testDb.open( database5 );
+
+    for ( U32 id = 0; ( statusOk && ( id < ( nbRecords / nbDuplicates ))); id++ ) {
+        U32 searchId = id;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && ( testDb.getSearchCount( key ) == nbDuplicates );
+
+        // The selection starts at the record found.
+        for ( U32 j = 1; ( statusOk && ( j < nbDuplicates )); j++ ) {
+            U32 prevIndex = index;
+            statusOk = testDb.getNextRecord( 0, testRecord, index );
+            statusOk = statusOk && ( testObject.id == id );
+            statusOk = statusOk && (( j == 1 ) ? ( index == prevIndex ) : ( index > prevIndex ));
+        }
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test sorting the key indices by several threads.
+ *
+ *  @return  True if successful.
+ */
+bool test18( void )
+/*============================================================================*/
+{
+    printDescription( 18, "Parallel sort of the key indices" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sOPTIONS options;
+    options.sortThreads = 4;
+
+    bool statusOk = testDb.open( database1, READ_WRITE_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+
+    // Every record is found by both keys.
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        U32 searchId = testObjects[ i ].id;
+        OSNDXFIO::sKEY idKey( 1, sizeof( searchId ), (BYTE*)&searchId ); // 1 == key2.
+        U32 index = INVALID_VALUE;
+        statusOk = testDb.existRecord( idKey, index );
+        statusOk = statusOk && ( testObjects[ index ].id == testObjects[ i ].id );
+
+        BYTE searchKey[ SIZE_OF_DEPARTMENT ];
+        ::memcpy( searchKey, testObjects[ i ].department, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY departmentKey( 0, SIZE_OF_DEPARTMENT, searchKey ); // 0 == key1.
+        statusOk = statusOk && testDb.existRecord( departmentKey, index );
+        statusOk = statusOk && ( ::memcmp( testObjects[ index ].department, testObjects[ i ].department,
+                                           SIZE_OF_DEPARTMENT ) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test the side file of the sorted key indices.
+ *
+ *  @return  True if successful.
+ */
+bool test19( void )
+/*============================================================================*/
+{
+    printDescription( 19, "Save and load sorted key indices" );
+
+    OSNDXFIO testDb;
+    OSFIO sortOrderFile;
+    OSNDXFIO::sOPTIONS options;
+    options.saveSortOrder = true;
+    OSNDXFIO::sKEY_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    char sortOrderName[] = STORAGE_PREFIX "testDb5.dat" SORT_ORDER_EXTENSION;
+    U32 const nbRecords = 1000;
+    U32 index = INVALID_VALUE;
+
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = nbRecords - i;
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.close();
+    statusOk = statusOk && !sortOrderFile.open( sortOrderName, READ_ONLY_ACCESS ); // Fails, not saved!
+
+    // The key index sorted by open() is saved by close().
+    statusOk = statusOk && testDb.open( database5, READ_WRITE_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+    statusOk = statusOk && testDb.close();
+
+    // One key index of all index records follows the header.
+    statusOk = statusOk && sortOrderFile.open( sortOrderName, READ_ONLY_ACCESS );
+    statusOk = statusOk && ( sortOrderFile.size() > ( nbRecords * sizeof( U32 )));
+    statusOk = statusOk && sortOrderFile.close();
+
+    // Loaded instead of sorted, a new record makes the file stale.
+    for ( U32 pass = 0; ( statusOk && ( pass < 2 )); pass++ ) {
+        statusOk = testDb.open( database5 );
+        statusOk = statusOk && testDb.getKeyStats( 0, stats );
+        statusOk = statusOk && ( stats.sorts == pass );
+
+        for ( U32 id = 1; ( statusOk && ( id <= ( nbRecords + pass ))); id++ ) {
+            U32 searchId = id;
+            OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+            statusOk = testDb.existRecord( key, index );
+            statusOk = statusOk && testDb.getRecord( index, testRecord );
+            statusOk = statusOk && ( testObject.id == id );
+        }
+
+        testObject.id = nbRecords + 1;
+        statusOk = statusOk && (( pass > 0 ) || testDb.createRecord( testRecord, index ));
+        statusOk = statusOk && testDb.close();
+    }
+
+    // A damaged file of the right size is rejected, open() sorts.
+    statusOk = statusOk && testDb.open( database5, READ_WRITE_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+    statusOk = statusOk && testDb.close();
+    statusOk = statusOk && sortOrderFile.open( sortOrderName, READ_WRITE_ACCESS );
+
+    U64 position = sortOrderFile.size() - (( sortOrderFile.size() / 2 ) & ~U64( 3 ));
+    U32 entries[ 2 ];
+    statusOk = statusOk && sortOrderFile.read( position, entries, sizeof( entries ));
+    U32 swapped[ 2 ] = { entries[ 1 ], entries[ 0 ] };
+    statusOk = statusOk && sortOrderFile.write( position, swapped, sizeof( swapped ));
+    statusOk = sortOrderFile.close() && statusOk;
+    statusOk = statusOk && testDb.open( database5 );
+    statusOk = statusOk && testDb.getKeyStats( 0, stats );
+    statusOk = statusOk && ( stats.sorts == 1 );
+
+    for ( U32 id = 1; ( statusOk && ( id <= ( nbRecords + 1 ))); id++ ) {
+        U32 searchId = id;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && testDb.getRecord( index, testRecord );
+        statusOk = statusOk && ( testObject.id == id );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)OSFIO::erase( database5 );
+    (void)OSFIO::erase( sortOrderName );
+
+    // Records created past the reserved index records, the file is loaded.
+    U16 const nbReserved = 10;
+    statusOk = statusOk && testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc, nbReserved, options );
+
+    for ( U32 pass = 0; ( statusOk && ( pass < 2 )); pass++ ) {
+        for ( U32 i = 0; ( statusOk && ( i < ( nbReserved + 5 ))); i++ ) {
+            testObject.id = ( pass * ( nbReserved + 5 )) + i + 1;
+            statusOk = testDb.createRecord( testRecord, index );
+        }
+
+        statusOk = statusOk && testDb.close();
+        statusOk = statusOk && testDb.open( database5, READ_WRITE_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+        statusOk = statusOk && testDb.getKeyStats( 0, stats );
+        statusOk = statusOk && ( stats.sorts == 0 );
+    }
+
+    for ( U32 id = 1; ( statusOk && ( id <= ( 2 * ( nbReserved + 5 )))); id++ ) {
+        U32 searchId = id;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && testDb.getRecord( index, testRecord );
+        statusOk = statusOk && ( testObject.id == id );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+    (void)OSFIO::erase( sortOrderName );
+
+    return statusOk;
+}
+
+/**
+ *  Test lookups interleaved with record creations and updates.
+ *
+ *  @return  True if successful.
+ */
+bool test20( void )
+/*============================================================================*/
+{
+    printDescription( 20, "Lookups between creations and updates" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 2 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    keyDesc[ 1 ].nrOfSegments = NR_ELEMENTS( ::key3 );
+    keyDesc[ 1 ].apSegment    = ::key3;
+    U32 const nbRecords = 500;
+    U32 index = INVALID_VALUE;
+
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    // Ids in scattered order, every new record is found at once.
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = ( i * 7919 ) % nbRecords;
+        ::sprintf( testObject.name, "NAME-%u", ( i % 10 ));
+        statusOk = testDb.createRecord( testRecord, index );
+        statusOk = statusOk && ( index == i );
+
+        for ( U32 j = 0; ( statusOk && ( j <= i )); j += 50 ) {
+            U32 searchId = ( j * 7919 ) % nbRecords;
+            OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+            statusOk = testDb.existRecord( key, index );
+            statusOk = statusOk && ( testDb.getSearchCount( key ) == 1 );
+            statusOk = statusOk && ( index == j );
+        }
+    }
+
+    // A record changes its key.
+    statusOk = statusOk && testDb.getRecord( 10, testRecord );
+    U32 const oldId = testObject.id;
+    testObject.id   = nbRecords + 10;
+    statusOk = statusOk && testDb.updateRecord( 10, testRecord );
+
+    U32 searchId = oldId;
+    OSNDXFIO::sKEY oldKey( 0, sizeof( searchId ), (BYTE*)&searchId );
+    statusOk = statusOk && !testDb.existRecord( oldKey, index ); // Fails, updated!
+
+    searchId = nbRecords + 10;
+    OSNDXFIO::sKEY newKey( 0, sizeof( searchId ), (BYTE*)&searchId );
+    statusOk = statusOk && testDb.existRecord( newKey, index );
+    statusOk = statusOk && ( index == 10 );
+
+    // Equal names are ordered by id.
+    char searchName[ SIZE_OF_NAME + sizeof( U32 ) ];
+    ::memset( searchName, 0, sizeof( searchName ));
+    ::strcpy( searchName, "NAME-3" );
+    OSNDXFIO::sKEY nameKey( 1, SIZE_OF_NAME, (BYTE*)searchName );
+    statusOk = statusOk && testDb.existRecord( nameKey, index );
+    statusOk = statusOk && ( testDb.getSearchCount( nameKey ) == ( nbRecords / 10 ));
+
+    U32 prevId = 0;
+    for ( U32 j = 1; ( statusOk && ( j < testDb.getSearchCount( nameKey ))); j++ ) {
+        statusOk = testDb.getNextRecord( 1, testRecord, index );
+        statusOk = statusOk && (( j == 1 ) || ( testObject.id > prevId ));
+        prevId   = testObject.id;
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test updates of payload and of single keys.
+ *
+ *  @return  True if successful.
+ */
+bool test21( void )
+/*============================================================================*/
+{
+    printDescription( 21, "Updates changing single keys" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 2 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    keyDesc[ 1 ].nrOfSegments = NR_ELEMENTS( ::key3 );
+    keyDesc[ 1 ].apSegment    = ::key3;
+    U32 const nbRecords = 100;
+    U32 index = INVALID_VALUE;
+    char searchName[ SIZE_OF_NAME + sizeof( U32 ) ];
+
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = i;
+        ::sprintf( testObject.name, "NAME-%u", i );
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+
+        if ( IS_EVEN( i )) {
+            // Payload only, both keys are unchanged.
+            testObject.data[ 0 ] = BYTE( i );
+        } else {
+            // The name key only.
+            ::sprintf( testObject.name, "NEW-%u", i );
+        }
+
+        statusOk = statusOk && testDb.updateRecord( i, testRecord );
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        U32 searchId = i;
+        OSNDXFIO::sKEY idKey( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( idKey, index );
+        statusOk = statusOk && ( index == i );
+        statusOk = statusOk && testDb.getRecord( index, testRecord );
+        statusOk = statusOk && ( !IS_EVEN( i ) || ( testObject.data[ 0 ] == BYTE( i )));
+
+        ::memset( searchName, 0, sizeof( searchName ));
+        ::sprintf( searchName, ( IS_EVEN( i ) ? "NAME-%u" : "NEW-%u" ), i );
+        OSNDXFIO::sKEY nameKey( 1, SIZE_OF_NAME, (BYTE*)searchName );
+        statusOk = statusOk && testDb.existRecord( nameKey, index );
+        statusOk = statusOk && ( index == i );
+    }
+
+    // Old names are gone.
+    ::memset( searchName, 0, sizeof( searchName ));
+    ::strcpy( searchName, "NAME-1" );
+    OSNDXFIO::sKEY nameKey( 1, SIZE_OF_NAME, (BYTE*)searchName );
+    statusOk = statusOk && !testDb.existRecord( nameKey, index ); // Fails, renamed!
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test the append fast path of ascending keys.
+ *
+ *  @return  True if successful.
+ */
+bool test22( void )
+/*============================================================================*/
+{
+    printDescription( 22, "Append ascending keys" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sKEY_STATS stats;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 2 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    keyDesc[ 1 ].nrOfSegments = NR_ELEMENTS( ::key3 );
+    keyDesc[ 1 ].apSegment    = ::key3;
+    U32 const nbRecords = 200;
+    U32 index = INVALID_VALUE;
+
+    bool statusOk = !testDb.getKeyStats( 0, stats ); // Fails, not opened!
+    statusOk = statusOk && testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+    statusOk = statusOk && !testDb.getKeyStats( NR_ELEMENTS( keyDesc ), stats ); // Fails!
+
+    // Ascending ids, descending names.
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = i;
+        ::sprintf( testObject.name, "NAME-%03u", ( nbRecords - i ));
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        U32 searchId = i;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && ( index == i );
+    }
+
+    statusOk = statusOk && testDb.getKeyStats( 0, stats );
+    statusOk = statusOk && ( stats.appends == nbRecords ) && ( stats.inserts == 0 ) && ( stats.sorts == 1 );
+    statusOk = statusOk && testDb.getKeyStats( 1, stats );
+    statusOk = statusOk && ( stats.appends == 1 ) && ( stats.inserts == ( nbRecords - 1 )) && ( stats.sorts == 1 );
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test lookups in contiguous key arrays.
+ *
+ *  @return  True if successful.
+ */
+bool test23( void )
+/*============================================================================*/
+{
+    printDescription( 23, "Lookups in contiguous key arrays" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO::sOPTIONS options;
+    options.keyArrays = true;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    U32 const nbRecords = 300;
+    U32 index = INVALID_VALUE;
+
+    // The key arrays follow creations and updates.
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc,
+                                   OSNDXFIO::DEFAULT_RESERVED_INDEX_RECORDS, options );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = ( i * 7919 ) % nbRecords;
+        statusOk = testDb.createRecord( testRecord, index );
+
+        U32 searchId = testObject.id;
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = statusOk && testDb.existRecord( key, index );
+        statusOk = statusOk && ( index == i );
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i += 3 ) {
+        statusOk = testDb.getRecord( i, testRecord );
+        testObject.id += nbRecords;
+        statusOk = statusOk && testDb.updateRecord( i, testRecord );
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        U32 searchId = (( i * 7919 ) % nbRecords ) + ((( i % 3 ) == 0 ) ? nbRecords : 0 );
+        OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = testDb.existRecord( key, index );
+        statusOk = statusOk && ( index == i );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    // Every record of a sorted database is found by both keys.
+    statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS, options );
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        U32 searchId = testObjects[ i ].id;
+        OSNDXFIO::sKEY idKey( 1, sizeof( searchId ), (BYTE*)&searchId ); // 1 == key2.
+        statusOk = testDb.existRecord( idKey, index );
+        statusOk = statusOk && ( testObjects[ index ].id == testObjects[ i ].id );
+
+        BYTE searchKey[ SIZE_OF_DEPARTMENT ];
+        ::memcpy( searchKey, testObjects[ i ].department, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY departmentKey( 0, SIZE_OF_DEPARTMENT, searchKey ); // 0 == key1.
+        statusOk = statusOk && testDb.existRecord( departmentKey, index );
+        statusOk = statusOk && ( ::memcmp( testObjects[ index ].department, testObjects[ i ].department,
+                                           SIZE_OF_DEPARTMENT ) == 0 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test sorting long keys with a common prefix.
+ *
+ *  @return  True if successful.
+ */
+bool test24( void )
+/*============================================================================*/
+{
+    printDescription( 24, "Sort long keys with a common prefix" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key1 );
+    keyDesc[ 0 ].apSegment    = ::key1;
+    U32 const nbDepartments = 10;
+    U32 const nbNames       = 200;
+    U32 const nbDuplicates  = 2;
+    U32 index               = INVALID_VALUE;
+    char buffer[ 32 ];
+
+    // All keys start with "MY_DEPAR", the order is decided by the rest.
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    for ( U32 i = 0; ( statusOk && ( i < ( nbDepartments * nbNames * nbDuplicates ))); i++ ) {
+        U32 value = ( i * 7919 ) % ( nbDepartments * nbNames );
+        ::sprintf( buffer, "MY_DEPARTMENT-%u", value % nbDepartments );
+        ::memcpy( testObject.department, buffer, SIZE_OF_DEPARTMENT );
+        ::sprintf( testObject.name, "NEW-%05u", nbNames - ( value / nbDepartments ));
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.close();
+
+    // The index is sorted on open, names ascending within a department.
+    statusOk = statusOk && testDb.open( database5 );
+
+    for ( U32 d = 0; ( statusOk && ( d < nbDepartments )); d++ ) {
+        BYTE searchKey[ SIZE_OF_DEPARTMENT + SIZE_OF_NAME ];
+        ::sprintf( buffer, "MY_DEPARTMENT-%u", d );
+        ::memcpy( searchKey, buffer, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY departmentKey( 0, SIZE_OF_DEPARTMENT, searchKey ); // 0 == key1.
+        statusOk = testDb.existRecord( departmentKey, index );
+        statusOk = statusOk && ( testDb.getSearchCount( departmentKey ) == ( nbNames * nbDuplicates ));
+
+        char prevName[ SIZE_OF_NAME ];
+        ::memset( prevName, 0, SIZE_OF_NAME );
+
+        for ( U32 j = 1; ( statusOk && ( j < ( nbNames * nbDuplicates ))); j++ ) {
+            statusOk = testDb.getNextRecord( 0, testRecord, index );
+            statusOk = statusOk && ( ::memcmp( testObject.department, searchKey, SIZE_OF_DEPARTMENT ) == 0 );
+            statusOk = statusOk && ( ::memcmp( prevName, testObject.name, SIZE_OF_NAME ) <= 0 );
+            ::memcpy( prevName, testObject.name, SIZE_OF_NAME );
+        }
+
+        // Every full key is found, equal keys are counted.
+        for ( U32 n = 1; ( statusOk && ( n <= nbNames )); n++ ) {
+            ::sprintf( (char*)( searchKey + SIZE_OF_DEPARTMENT ), "NEW-%05u", n );
+            OSNDXFIO::sKEY fullKey( 0, sizeof( searchKey ), searchKey );
+            statusOk = testDb.existRecord( fullKey, index );
+            statusOk = statusOk && ( testDb.getSearchCount( fullKey ) == nbDuplicates );
+            statusOk = statusOk && testDb.getRecord( index, testRecord );
+            statusOk = statusOk && ( ::memcmp( testObject.name, searchKey + SIZE_OF_DEPARTMENT, SIZE_OF_NAME ) == 0 );
+        }
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test lookups by keys of 2, 6, 8, 16 and 24 bytes.
+ *
+ *  @return  True if successful.
+ */
+bool test25( void )
+/*============================================================================*/
+{
+    printDescription( 25, "Compare keys of different sizes" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_SEGMENT keyU16[ 1 ] = {
+        OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU16, sizeof( U16 ))
+    }; // 2 bytes.
+    OSNDXFIO::sKEY_SEGMENT keyU16U32[ 2 ] = {
+        OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU16, sizeof( U16 )),
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_NAME, OSNDXFIO::tU32, sizeof( U32 ))
+    }; // 6 bytes.
+    OSNDXFIO::sKEY_SEGMENT keyU32U32[ 2 ] = {
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_NAME, OSNDXFIO::tU32, sizeof( U32 )),
+        OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU32, sizeof( U32 ))
+    }; // 8 bytes.
+    OSNDXFIO::sKEY_SEGMENT keyName[ 3 ] = {
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_NAME, OSNDXFIO::tBYTE, SIZE_OF_NAME ),
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_DEPARTMENT, OSNDXFIO::tBYTE, 2 ),
+        OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU32, sizeof( U32 ))
+    }; // 16 bytes.
+    OSNDXFIO::sKEY_SEGMENT keyDepartment[ 3 ] = {
+        OSNDXFIO::sKEY_SEGMENT( 0, OSNDXFIO::tU32, sizeof( U32 )),
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_DEPARTMENT, OSNDXFIO::tBYTE, 10 ),
+        OSNDXFIO::sKEY_SEGMENT( OFFSET_NAME, OSNDXFIO::tBYTE, SIZE_OF_NAME )
+    }; // 24 bytes.
+    OSNDXFIO::sKEY_DESC keyDesc[ 5 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( keyU16 );
+    keyDesc[ 0 ].apSegment    = keyU16;
+    keyDesc[ 1 ].nrOfSegments = NR_ELEMENTS( keyU16U32 );
+    keyDesc[ 1 ].apSegment    = keyU16U32;
+    keyDesc[ 2 ].nrOfSegments = NR_ELEMENTS( keyU32U32 );
+    keyDesc[ 2 ].apSegment    = keyU32U32;
+    keyDesc[ 3 ].nrOfSegments = NR_ELEMENTS( keyName );
+    keyDesc[ 3 ].apSegment    = keyName;
+    keyDesc[ 4 ].nrOfSegments = NR_ELEMENTS( keyDepartment );
+    keyDesc[ 4 ].apSegment    = keyDepartment;
+    U32 const nbRecords = 1000;
+    U32 index = INVALID_VALUE;
+    char buffer[ 32 ];
+
+    // Ids above 255 differ in both bytes, names share their first bytes.
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        testObject.id = (( i * 7919 ) % nbRecords ) * 61;
+        ::sprintf( testObject.name, "NEW-%05u", ( i % 10 ));
+        ::sprintf( buffer, "MY_DEPARTMENT-%u", ( i % 3 ));
+        ::memcpy( testObject.department, buffer, SIZE_OF_DEPARTMENT );
+        statusOk = testDb.createRecord( testRecord, index );
+    }
+
+    statusOk = statusOk && testDb.close();
+
+    // Every record is found by each key, the keys are unique.
+    statusOk = statusOk && testDb.open( database5 );
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        statusOk = testDb.getRecord( i, testRecord );
+
+        for ( U16 k = 0; ( statusOk && ( k < NR_ELEMENTS( keyDesc ))); k++ ) {
+            BYTE searchKey[ 32 ];
+            U16  size = 0;
+
+            for ( U16 j = 0; j < keyDesc[ k ].nrOfSegments; j++ ) {
+                ::memcpy(( searchKey + size ), ( (BYTE*)&testObject + keyDesc[ k ].apSegment[ j ].offset ),
+                         keyDesc[ k ].apSegment[ j ].size );
+                size = U16( size + keyDesc[ k ].apSegment[ j ].size );
+            }
+
+            OSNDXFIO::sKEY key( k, size, searchKey );
+            statusOk = testDb.existRecord( key, index );
+            statusOk = statusOk && ( index == i );
+        }
+
+        // A partial key of 4 bytes compares by its own kernel.
+        U32 searchId = testObject.id;
+        OSNDXFIO::sKEY idKey( 4, sizeof( searchId ), (BYTE*)&searchId );
+        statusOk = statusOk && testDb.existRecord( idKey, index );
+        statusOk = statusOk && ( index == i ) && ( testDb.getSearchCount( idKey ) == 1 );
+    }
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
+/**
+ *  Test lookups in the search layout of read-only databases.
+ *
+ *  @return  True if successful.
+ */
+bool test26( void )
+/*============================================================================*/
+{
+    printDescription( 26, "Lookups in the read-only search layout" );
+
+    OSNDXFIO testDb;
+    OSNDXFIO referenceDb;
+    OSNDXFIO::sOPTIONS options;
+    options.searchLayout = true;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key2 );
+    keyDesc[ 0 ].apSegment    = ::key2;
+    U32 index = INVALID_VALUE;
+
+    // Even ids of every tree size, odd ids are missing.
+    bool statusOk = true;
+
+    for ( U32 nbRecords = 2; ( statusOk && ( nbRecords <= 40 )); nbRecords++ ) {
+        statusOk = testDb.create( database4, NR_ELEMENTS( keyDesc ), keyDesc );
+
+        for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+            testObject.id = 2 * ( nbRecords - 1 - ( i / 2 ));
+            statusOk = testDb.createRecord( testRecord, index );
+        }
+
+        statusOk = statusOk && testDb.close();
+        statusOk = statusOk && testDb.open( database4, READ_ONLY_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS,
+                                            options );
+
+        for ( U32 id = 0; ( statusOk && ( id <= ( 2 * nbRecords ))); id++ ) {
+            U32 searchId = id;
+            OSNDXFIO::sKEY key( 0, sizeof( searchId ), (BYTE*)&searchId );
+            U32 count = 0;
+
+            for ( U32 i = 0; i < nbRecords; i++ ) {
+                count += ( 2 * ( nbRecords - 1 - ( i / 2 )) == id ) ? 1 : 0;
+            }
+
+            statusOk = ( testDb.existRecord( key, index ) == ( count > 0 ));
+            statusOk = statusOk && (( count > 0 ) ? ( testDb.getSearchCount( key ) == count ) :
+                                    ( testDb.getLastError() == OSNDXFIO::ENTRY_NOT_FOUND ));
+            statusOk = statusOk && (( count == 0 ) || ( testDb.getRecord( index, testRecord ) &&
+                                                        ( testObject.id == id )));
+        }
+
+        statusOk = statusOk && testDb.close();
+        (void)testDb.close();
+        (void)OSFIO::erase( database4 );
+    }
+
+    // The layout gives the results of the binary search.
+    statusOk = statusOk && referenceDb.open( database1, READ_ONLY_ACCESS );
+    statusOk = statusOk && testDb.open( database1, READ_ONLY_ACCESS, OSNDXFIO::DEFAULT_ALLOCATED_INDEX_KEYS,
+                                        options );
+
+    for ( U32 id = 0; ( statusOk && ( id < ( 2 * MAX_NB_IDS ))); id++ ) {
+        U32 searchId = id;
+        OSNDXFIO::sKEY key( 1, sizeof( searchId ), (BYTE*)&searchId ); // 1 == key2.
+        U32 referenceId = id;
+        OSNDXFIO::sKEY referenceKey( 1, sizeof( referenceId ), (BYTE*)&referenceId );
+        U32 referenceIndex = INVALID_VALUE;
+
+        bool found = referenceDb.existRecord( referenceKey, referenceIndex );
+        statusOk = ( testDb.existRecord( key, index ) == found ) && ( index == referenceIndex );
+        statusOk = statusOk && ( testDb.getSearchCount( key ) == referenceDb.getSearchCount( referenceKey ));
+    }
+
+    for ( U32 i = 0; ( statusOk && ( i < testDb.getNrOfRecords() )); i++ ) {
+        BYTE searchKey[ SIZE_OF_DEPARTMENT ];
+        ::memcpy( searchKey, testObjects[ i ].department, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY departmentKey( 0, SIZE_OF_DEPARTMENT, searchKey ); // 0 == key1.
+        BYTE referenceKey[ SIZE_OF_DEPARTMENT ];
+        ::memcpy( referenceKey, testObjects[ i ].department, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY referenceDepartmentKey( 0, SIZE_OF_DEPARTMENT, referenceKey );
+        U32 referenceIndex = INVALID_VALUE;
+
+        statusOk = testDb.existRecord( departmentKey, index );
+        statusOk = statusOk && referenceDb.existRecord( referenceDepartmentKey, referenceIndex );
+        statusOk = statusOk && ( index == referenceIndex );
+        statusOk = statusOk && ( testDb.getSearchCount( departmentKey ) ==
+                                 referenceDb.getSearchCount( referenceDepartmentKey ));
+    }
+
+    statusOk = statusOk && testDb.close() && referenceDb.close();
+    (void)testDb.close();
+    (void)referenceDb.close();
+
+    return statusOk;
+}
+
+/**
+ *  Test the selection of many equal keys.
+ *
+ *  @return  True if successful.
+ */
+bool test27( void )
+/*============================================================================*/
+{
+    printDescription( 27, "Select many equal keys" );
+
+    OSNDXFIO testDb;
+    sTEST_OBJECT testObject;
+    OSNDXFIO::sRECORD testRecord( sizeof( sTEST_OBJECT ), 0, sizeof( sTEST_OBJECT ), (BYTE*)&testObject );
+    OSNDXFIO::sKEY_DESC keyDesc[ 1 ];
+    keyDesc[ 0 ].nrOfSegments = NR_ELEMENTS( ::key1 );
+    keyDesc[ 0 ].apSegment    = ::key1;
+    U32 const nbDepartments = 10;
+    U32 const nbRecords     = 20000;
+    U32 index               = INVALID_VALUE;
+    char buffer[ 32 ];
+
+    // Department d holds d / 45 of the records, department 0 none.
+    bool statusOk = testDb.create( database5, NR_ELEMENTS( keyDesc ), keyDesc );
+    U32 counts[ nbDepartments ];
+    ::memset( counts, 0, sizeof( counts ));
+
+    for ( U32 i = 0; ( statusOk && ( i < nbRecords )); i++ ) {
+        U32 department = 1;
+
+        while ((( department * ( department + 1 )) / 2 ) <= (( i * 45 ) / nbRecords )) {
+            department++;
+        }
+
+        ::sprintf( buffer, "MY_DEPARTMENT-%u", department );
+        ::memcpy( testObject.department, buffer, SIZE_OF_DEPARTMENT );
+        ::sprintf( testObject.name, "NEW-%05u", ( i % 1000 ));
+        statusOk = testDb.createRecord( testRecord, index );
+        counts[ department ]++;
+    }
+
+    // Each selection covers all equal keys, from the first to the last.
+    for ( U32 d = 0; ( statusOk && ( d < nbDepartments )); d++ ) {
+        BYTE searchKey[ SIZE_OF_DEPARTMENT ];
+        ::sprintf( buffer, "MY_DEPARTMENT-%u", d );
+        ::memcpy( searchKey, buffer, SIZE_OF_DEPARTMENT );
+        OSNDXFIO::sKEY key( 0, SIZE_OF_DEPARTMENT, searchKey ); // 0 == key1.
+
+        statusOk = ( testDb.existRecord( key, index ) == ( counts[ d ] > 0 ));
+        statusOk = statusOk && (( counts[ d ] == 0 ) || ( testDb.getSearchCount( key ) == counts[ d ] ));
+
+        U32 selected = ( counts[ d ] > 0 ) ? 1 : 0;
+
+        while ( statusOk && ( selected > 0 ) && testDb.getNextRecord( 0, testRecord, index )) {
+            statusOk = ( ::memcmp( testObject.department, searchKey, SIZE_OF_DEPARTMENT ) == 0 );
+            selected++;
+        }
+
+        // getNextRecord() starts at the record found.
+        statusOk = statusOk && (( counts[ d ] == 0 ) || ( selected == counts[ d ] ));
+    }
+
+    // A partial key selects all departments.
+    BYTE prefix[] = "MY_DEPARTMENT-";
+    OSNDXFIO::sKEY prefixKey( 0, ( sizeof( prefix ) - 1 ), prefix );
+    statusOk = statusOk && testDb.existRecord( prefixKey, index );
+    statusOk = statusOk && ( testDb.getSearchCount( prefixKey ) == nbRecords );
+
+    statusOk = statusOk && testDb.close();
+    (void)testDb.close();
+    (void)OSFIO::erase( database5 );
+
+    return statusOk;
+}
+
 /*============================================================================*/
 int main()
 /*============================================================================*/
@@ -336,16 +1796,39 @@ int main()
     time_t startTime;
     ::time( &startTime );
     ::printf( "OSNDXFIO TEST started at %s\n", ::ctime( &startTime ));
-    ::printf( "OSNDXFIO size of type eERROR = %d\n", sizeof( OSNDXFIO::eERROR ));
-    ::printf( "OSNDXFIO size of type eTYPE = %d\n", sizeof( OSNDXFIO::eTYPE ));
-    ::printf( "OSNDXFIO size of type sKEY_SEGMENT = %d\n", sizeof( OSNDXFIO::sKEY_SEGMENT ));
-    ::printf( "OSNDXFIO size of type sKEY_DESC = %d\n", sizeof( OSNDXFIO::sKEY_DESC ));
-    ::printf( "OSNDXFIO size of type sRECORD = %d\n\n", sizeof( OSNDXFIO::sRECORD ));
+    ::printf( "OSNDXFIO size of type eERROR = %d\n", int( sizeof( OSNDXFIO::eERROR )));
+    ::printf( "OSNDXFIO size of type eTYPE = %d\n", int( sizeof( OSNDXFIO::eTYPE )));
+    ::printf( "OSNDXFIO size of type sKEY_SEGMENT = %d\n", int( sizeof( OSNDXFIO::sKEY_SEGMENT )));
+    ::printf( "OSNDXFIO size of type sKEY_DESC = %d\n", int( sizeof( OSNDXFIO::sKEY_DESC )));
+    ::printf( "OSNDXFIO size of type sRECORD = %d\n\n", int( sizeof( OSNDXFIO::sRECORD )));
 
     printResult( test1());
     printResult( test2());
     printResult( test3());
     printResult( test4());
+    printResult( test5());
+    printResult( test6());
+    printResult( test7());
+    printResult( test8());
+    printResult( test9());
+    printResult( test10());
+    printResult( test11());
+    printResult( test12());
+    printResult( test13());
+    printResult( test14());
+    printResult( test15());
+    printResult( test16());
+    printResult( test17());
+    printResult( test18());
+    printResult( test19());
+    printResult( test20());
+    printResult( test21());
+    printResult( test22());
+    printResult( test23());
+    printResult( test24());
+    printResult( test25());
+    printResult( test26());
+    printResult( test27());
 
     ::printf( "\nOSNDXFIO TEST %d passed, %d failed, stopped at %s\n\n", passedCounter, failedCounter, ::ctime( &startTime ));
 